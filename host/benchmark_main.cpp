@@ -0,0 +1,7 @@
+#include "benchmark.h"
+
+int main(void)
+{
+    benchmark_run();
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef HOST_ARM_ACLE_H_
+#define HOST_ARM_ACLE_H_
+
+// Host replacement for the ACLE SIMD32 intrinsics the Fletcher16 kernel uses, so its SIMD path
+// can be checked off target. Same results as the Cortex-M instructions, saturation flags aside.
+#include <stdint.h>
+
+// Zero extends bytes 0 and 2 into the low and high halfwords
+static inline uint32_t __uxtb16(uint32_t x)
+{
+    return x & 0x00FF00FFu;
+}
+
+static inline uint32_t __ror(uint32_t x, uint32_t y)
+{
+    y &= 31;
+    return y ? (x >> y) | (x << (32 - y)) : x;
+}
+
+// Signed 16 bit products of the low and of the high halfwords, added
+static inline int32_t __smuad(int32_t x, int32_t y)
+{
+    return (int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+}
+
+static inline int32_t __smlad(int32_t x, int32_t y, int32_t accumulator)
+{
+    return (int32_t)((uint32_t)accumulator + (uint32_t)__smuad(x, y));
+}
+
+// Sum of the absolute differences of the 4 unsigned bytes, added to the accumulator
+static inline uint32_t __usada8(uint32_t x, uint32_t y, uint32_t accumulator)
+{
+    for (uint32_t shift = 0; shift < 32; shift += 8)
+    {
+        int32_t difference = (int32_t)((x >> shift) & 0xFF) - (int32_t)((y >> shift) & 0xFF);
+        accumulator += (uint32_t)(difference < 0 ? -difference : difference);
+    }
+    return accumulator;
+}
+
+#endif /* HOST_ARM_ACLE_H_ */
@@ -0,0 +1,14 @@
+#ifndef HOST_ZEPHYR_LOGGING_LOG_H_
+#define HOST_ZEPHYR_LOGGING_LOG_H_
+
+// Host replacement for the Zephyr logging macros, prints to stdout
+#include <stdio.h>
+
+#define LOG_MODULE_REGISTER(...)
+
+#define LOG_ERR(fmt, ...) printf("<err> " fmt "\n", ##__VA_ARGS__)
+#define LOG_WRN(fmt, ...) printf("<wrn> " fmt "\n", ##__VA_ARGS__)
+#define LOG_INF(fmt, ...) printf("<inf> " fmt "\n", ##__VA_ARGS__)
+#define LOG_DBG(fmt, ...) printf("<dbg> " fmt "\n", ##__VA_ARGS__)
+
+#endif /* HOST_ZEPHYR_LOGGING_LOG_H_ */
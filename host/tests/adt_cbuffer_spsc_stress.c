@@ -0,0 +1,256 @@
+#include "adt_cbuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * SPSC cbuffer stress test
+ *
+ * One thread produces a counting byte sequence while the main thread consumes and checks it.
+ * Both sides alternate between the copying calls (push/poll) and the zero-copy calls
+ * (claim/commit, peek/release), with chunk sizes that do not divide the buffer length so every
+ * wrap position is hit. Any lost, duplicated or reordered byte shows up as a mismatch.
+ *
+ * Then the same producer/consumer pair moves bytes through push/poll twice: once over the SPSC
+ * API and once over the plain cbuffer API with every call behind a spinlock, which is what a
+ * thread-safe cbuffer costs without it. Each is warmed up first, both throughputs are reported.
+ */
+
+#define STRESS_BYTES 1000000u
+#define STRESS_LENGTH 256 // Small, so head and tail chase each other and wrap often
+#define STRESS_PUSH_CHUNK 7
+#define STRESS_POLL_CHUNK 5
+#define THROUGHPUT_BYTES 4000000u
+#define THROUGHPUT_WARMUP_BYTES 400000u
+#define THROUGHPUT_CHUNK 16
+
+static uint8_t storage[STRESS_LENGTH];
+static Adt_CBufferSpsc_t ring;
+static Adt_CBuffer_t lockedRing;
+static pthread_spinlock_t lock;
+
+typedef Adt_Result_e (*Transfer_t)(void *buffer, uint16_t count);
+
+typedef struct Throughput_t_
+{
+    Transfer_t push;
+    uint32_t bytes;
+} Throughput_t;
+
+static uint16_t chunk(uint32_t sent, uint32_t max)
+{
+    uint32_t count = (sent % max) + 1;
+    return (uint16_t)((sent + count > STRESS_BYTES) ? STRESS_BYTES - sent : count);
+}
+
+static void *producer(void *arg)
+{
+    (void)arg;
+    uint32_t sent = 0;
+    uint8_t buffer[STRESS_PUSH_CHUNK];
+
+    while (sent < STRESS_BYTES)
+    {
+        uint16_t count = chunk(sent, STRESS_PUSH_CHUNK);
+
+        if ((sent / STRESS_PUSH_CHUNK) & 1)
+        {
+            Adt_CBufferSpan_t span;
+            if (adt_cbuffer_spscClaimWrite(&ring, &span) != ADT_OK)
+            {
+                sched_yield(); // Full, let the consumer run on single core hosts
+                continue;
+            }
+
+            count = (span.count < count) ? span.count : count;
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                span.data[i] = (uint8_t)(sent + i);
+            }
+            if (adt_cbuffer_spscCommitWrite(&ring, count) == ADT_OK)
+                sent += count;
+        }
+        else
+        {
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                buffer[i] = (uint8_t)(sent + i);
+            }
+            if (adt_cbuffer_spscPush(&ring, buffer, count) == ADT_OK)
+                sent += count;
+            else
+                sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static Adt_Result_e spscPush(void *buffer, uint16_t count)
+{
+    return adt_cbuffer_spscPush(&ring, buffer, count);
+}
+
+static Adt_Result_e spscPoll(void *buffer, uint16_t count)
+{
+    return adt_cbuffer_spscPoll(&ring, buffer, count);
+}
+
+static Adt_Result_e lockedPush(void *buffer, uint16_t count)
+{
+    pthread_spin_lock(&lock);
+    Adt_Result_e result = adt_cbuffer_push(&lockedRing, buffer, count);
+    pthread_spin_unlock(&lock);
+    return result;
+}
+
+static Adt_Result_e lockedPoll(void *buffer, uint16_t count)
+{
+    pthread_spin_lock(&lock);
+    Adt_Result_e result = adt_cbuffer_poll(&lockedRing, buffer, count);
+    pthread_spin_unlock(&lock);
+    return result;
+}
+
+static void *throughputProducer(void *arg)
+{
+    const Throughput_t *run = arg;
+    uint8_t buffer[THROUGHPUT_CHUNK] = {0};
+
+    for (uint32_t sent = 0; sent < run->bytes;)
+    {
+        if (run->push(buffer, THROUGHPUT_CHUNK) == ADT_OK)
+            sent += THROUGHPUT_CHUNK;
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+// Returns MB/s, or 0 when the producer thread could not be started
+static double throughput(Transfer_t push, Transfer_t poll, uint32_t bytes)
+{
+    Throughput_t run = {.push = push, .bytes = bytes};
+    pthread_t thread;
+    struct timespec start;
+    struct timespec end;
+    uint8_t buffer[THROUGHPUT_CHUNK];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (pthread_create(&thread, NULL, throughputProducer, &run) != 0)
+    {
+        return 0;
+    }
+
+    for (uint32_t received = 0; received < bytes;)
+    {
+        if (poll(buffer, THROUGHPUT_CHUNK) == ADT_OK)
+            received += THROUGHPUT_CHUNK;
+        else
+            sched_yield();
+    }
+
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    return (double)bytes / seconds / 1e6;
+}
+
+static int compareThroughput(void)
+{
+    if (adt_cbuffer_spscInit(&ring, storage, 1, STRESS_LENGTH) != ADT_OK ||
+        adt_cbuffer_init(&lockedRing, storage, 1, STRESS_LENGTH) != ADT_OK ||
+        pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE) != 0)
+    {
+        printf("throughput init failed\n");
+        return 1;
+    }
+
+    throughput(lockedPush, lockedPoll, THROUGHPUT_WARMUP_BYTES);
+    double locked = throughput(lockedPush, lockedPoll, THROUGHPUT_BYTES);
+
+    adt_cbuffer_spscReset(&ring);
+    throughput(spscPush, spscPoll, THROUGHPUT_WARMUP_BYTES);
+    double spsc = throughput(spscPush, spscPoll, THROUGHPUT_BYTES);
+
+    pthread_spin_destroy(&lock);
+
+    if (locked == 0 || spsc == 0)
+    {
+        printf("throughput run failed\n");
+        return 1;
+    }
+
+    printf("cbuffer+spinlock push/poll: %.1f MB/s\n", locked);
+    printf("spsc push/poll: %.1f MB/s (%.2fx)\n", spsc, spsc / locked);
+    return 0;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint8_t buffer[STRESS_POLL_CHUNK];
+
+    if (adt_cbuffer_spscInit(&ring, storage, 1, STRESS_LENGTH) != ADT_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    if (pthread_create(&thread, NULL, producer, NULL) != 0)
+    {
+        printf("pthread_create failed\n");
+        return 1;
+    }
+
+    while (received < STRESS_BYTES)
+    {
+        uint16_t count = chunk(received, STRESS_POLL_CHUNK);
+
+        if ((received / STRESS_POLL_CHUNK) & 1)
+        {
+            Adt_CBufferSpan_t spans[2];
+            if (adt_cbuffer_spscPeekContiguous(&ring, spans) <= 0)
+            {
+                sched_yield();
+                continue;
+            }
+
+            count = (spans[0].count < count) ? spans[0].count : count;
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                errors += (spans[0].data[i] != (uint8_t)(received + i));
+            }
+            if (adt_cbuffer_spscRelease(&ring, count) == ADT_OK)
+                received += count;
+        }
+        else if (adt_cbuffer_spscPoll(&ring, buffer, count) == ADT_OK)
+        {
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                errors += (buffer[i] != (uint8_t)(received + i));
+            }
+            received += count;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+
+    pthread_join(thread, NULL);
+
+    if (errors || adt_cbuffer_spscGetLength(&ring) != 0)
+    {
+        printf("FAIL: %u mismatched bytes, %d left\n", errors, (int)adt_cbuffer_spscGetLength(&ring));
+        return 1;
+    }
+
+    printf("OK: %u bytes\n", received);
+    return compareThroughput();
+}
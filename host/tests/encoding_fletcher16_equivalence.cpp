@@ -0,0 +1,107 @@
+#include "encoding_checksum.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Fletcher16 equivalence test
+ *
+ * Compares encoding_calculateFletcher16ChecksumWithSeed(...) against the original byte at a time
+ * loop over every length up to a few words, all four alignments and several seeds, plus lengths
+ * around the 5802 byte modulo block and buffers of 0xFF bytes, where the running sums are largest.
+ */
+
+#define FLETCHER_BUFFER_LENGTH 70000
+#define FLETCHER_SHORT_LENGTHS 200
+#define FLETCHER_ALIGNMENTS 4
+
+static uint8_t buffer[FLETCHER_BUFFER_LENGTH + FLETCHER_ALIGNMENTS];
+
+// Original implementation, kept as the reference
+static uint16_t fletcher16Reference(const uint8_t *data, uint32_t bytes, uint16_t seed)
+{
+    if (data == nullptr || bytes == 0)
+        return 0;
+
+    uint32_t c0 = seed & 0xff;
+    uint32_t c1 = (seed & 0xff00) >> 8;
+
+    static constexpr uint32_t max_blocklen = 5802;
+    do
+    {
+        uint32_t blocklen = bytes > max_blocklen ? max_blocklen : bytes;
+        bytes -= blocklen;
+        do
+        {
+            c0 += *data++;
+            c1 += c0;
+        } while (--blocklen);
+        c0 %= 255;
+        c1 %= 255;
+    } while (bytes > 0);
+    return static_cast<uint16_t>(c1 << 8 | c0);
+}
+
+static uint32_t random32(void)
+{
+    static uint32_t state = 0x12345678; // xorshift32, fixed seed so failures reproduce
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static uint32_t check(uint32_t length, uint16_t seed)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t offset = 0; offset < FLETCHER_ALIGNMENTS; ++offset)
+    {
+        uint16_t expected = fletcher16Reference(&buffer[offset], length, seed);
+        uint16_t actual = encoding_calculateFletcher16ChecksumWithSeed(&buffer[offset], length, seed);
+
+        if (actual != expected)
+        {
+            printf("FAIL: length %u offset %u seed 0x%04X: 0x%04X != 0x%04X\n", length, offset, seed,
+                   actual, expected);
+            ++errors;
+        }
+    }
+
+    return errors;
+}
+
+int main(void)
+{
+    static const uint16_t seeds[] = {0x0000, 0x1234, 0xFEFE, 0xFFFF};
+    static const uint32_t longLengths[] = {5801, 5802, 5803, 11604, 20000, 40000, 65536, FLETCHER_BUFFER_LENGTH};
+    uint32_t errors = 0;
+
+    for (int pattern = 0; pattern < 2; ++pattern)
+    {
+        for (uint32_t i = 0; i < sizeof(buffer); ++i)
+        {
+            buffer[i] = pattern ? 0xFF : static_cast<uint8_t>(random32());
+        }
+
+        for (uint16_t seed : seeds)
+        {
+            for (uint32_t length = 0; length < FLETCHER_SHORT_LENGTHS; ++length)
+            {
+                errors += check(length, seed);
+            }
+            for (uint32_t length : longLengths)
+            {
+                errors += check(length, seed);
+            }
+        }
+    }
+
+    if (errors)
+    {
+        printf("FAIL: %u mismatches\n", errors);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
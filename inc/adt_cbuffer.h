@@ -1,6 +1,10 @@
 #ifndef ADT_CBUFFER_H_
 #define ADT_CBUFFER_H_
 
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
 #include "adt_codes.h"
 #include <stdint.h>
 
@@ -88,6 +92,164 @@ Adt_Result_e adt_cbuffer_peek(Adt_CBuffer_t *handle, void *buffer);
  */
 Adt_Result_e adt_cbuffer_reset(Adt_CBuffer_t *handle);
 
+/*
+ * Single-producer / single-consumer variant
+ *
+ * Same data layout rules as above, but one context may push while another context peeks/polls
+ * without any lock. The producer only ever writes the head index and the consumer only ever
+ * writes the tail index; each side publishes its index with release ordering and observes the
+ * other side's index with acquire ordering. Indices are free running and masked, so the length
+ * must be a power of two.
+ */
+
+/**
+ * @brief Structure for lock-free single-producer/single-consumer cbuffer internals.
+ */
+typedef struct Adt_CBufferSpsc_t_ Adt_CBufferSpsc_t;
+
+/**
+ * @brief Initialize the SPSC cbuffer for use.
+ *
+ * Must complete before producer and consumer start using the buffer.
+ *
+ * @param[in] handle pointer to an allocated buffer struct.
+ * @param[in] buffer pointer to an allocated data array of the size required (@ref length).
+ * @param[in] size type size of a single element of the data array. Eg. sizeof(uint8_t).
+ * @param[in] length number of elements in the data array, must be a power of two.
+ * @returns ADT_OK on success or ADT_ERROR on failure / bad parameters.
+ */
+Adt_Result_e adt_cbuffer_spscInit(Adt_CBufferSpsc_t *handle, void *buffer, uint8_t size, uint16_t length);
+
+/**
+ * @brief Length of the SPSC cbuffer (number of stored items).
+ *
+ * Safe to call from either side. The value is exact for the caller's own side and a lower bound
+ * (consumer) or upper bound (producer) for what the other side is doing concurrently.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @returns number of elements in the cbuffer, or -1 if uninitialized or error.
+ */
+int32_t adt_cbuffer_spscGetLength(const Adt_CBufferSpsc_t *handle);
+
+/**
+ * @brief Push an item (or items) into the SPSC cbuffer. Producer side only.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[in] buffer array of data to store in the cbuffer, partitioned in chunks of typeSize.
+ * @param[in] count number of items from the data array to store.
+ * @returns ADT_OK on success or ADT_ERROR/ADT_NOT_READY/ADT_OVERFLOW on failure. Nothing is
+ * written on failure.
+ */
+Adt_Result_e adt_cbuffer_spscPush(Adt_CBufferSpsc_t *handle, const void *const buffer, uint16_t count);
+
+/**
+ * @brief Read and remove an item (or items) from the SPSC cbuffer. Consumer side only.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[out] buffer allocated array to store the read elements.
+ * @param[in] count number of items to read from the buffer.
+ * @returns ADT_OK on success or ADT_ERROR/ADT_NOT_READY/ADT_EMPTY/ADT_UNDERRUN on failure.
+ */
+Adt_Result_e adt_cbuffer_spscPoll(Adt_CBufferSpsc_t *handle, void *buffer, uint16_t count);
+
+/**
+ * @brief Read a single item from the SPSC cbuffer without removing it. Consumer side only.
+ *
+ * @param handle pointer to an allocated and initialized buffer struct.
+ * @param buffer pointer to a variable to store the read element.
+ * @returns ADT_OK on success or ADT_ERROR/ADT_NOT_READY/ADT_EMPTY on failure.
+ */
+Adt_Result_e adt_cbuffer_spscPeek(Adt_CBufferSpsc_t *handle, void *buffer);
+
+/**
+ * @brief Drop everything currently stored. Consumer side only.
+ *
+ * Data pushed concurrently by the producer after the call is kept.
+ *
+ * @param handle pointer to an allocated and initialized buffer struct.
+ * @returns ADT_OK on success or ADT_ERROR on failure.
+ */
+Adt_Result_e adt_cbuffer_spscReset(Adt_CBufferSpsc_t *handle);
+
+/**
+ * @brief View into the SPSC cbuffer storage.
+ *
+ * Stored (or free) data can wrap around the end of the backing array, in which case it is
+ * described by two spans: the first up to the end of the array and the second from its start.
+ * count is in elements; an unused span has count 0.
+ */
+typedef struct Adt_CBufferSpan_t_
+{
+    uint8_t *data;
+    uint16_t count;
+} Adt_CBufferSpan_t;
+
+/**
+ * @brief Claim free space to write into directly. Producer side only.
+ *
+ * Hands out the contiguous free region starting at the write position. Nothing becomes visible
+ * to the consumer until adt_cbuffer_spscCommitWrite(...). Claiming again without committing
+ * returns the same region.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[out] span contiguous free region, count is 0 if the buffer is full.
+ * @returns ADT_OK on success, ADT_OUT_OF_SPACE if full or ADT_ERROR/ADT_NOT_READY on failure.
+ */
+Adt_Result_e adt_cbuffer_spscClaimWrite(Adt_CBufferSpsc_t *handle, Adt_CBufferSpan_t *span);
+
+/**
+ * @brief Publish items written into a claimed region. Producer side only.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[in] count number of items written, must not exceed the last claimed span.
+ * @returns ADT_OK on success or ADT_ERROR/ADT_NOT_READY/ADT_OVERFLOW on failure.
+ */
+Adt_Result_e adt_cbuffer_spscCommitWrite(Adt_CBufferSpsc_t *handle, uint16_t count);
+
+/**
+ * @brief Look at all stored items in place. Consumer side only.
+ *
+ * The spans point into the backing storage and stay valid until the same items are released,
+ * the producer cannot overwrite them before that.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[out] spans two spans describing the stored data in order.
+ * @returns number of stored items (sum of both span counts), or -1 if uninitialized or error.
+ */
+int32_t adt_cbuffer_spscPeekContiguous(Adt_CBufferSpsc_t *handle, Adt_CBufferSpan_t spans[2]);
+
+/**
+ * @brief Remove items from the front without copying them. Consumer side only.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[in] count number of items to drop.
+ * @returns ADT_OK on success or ADT_ERROR/ADT_NOT_READY/ADT_EMPTY/ADT_UNDERRUN on failure.
+ */
+Adt_Result_e adt_cbuffer_spscRelease(Adt_CBufferSpsc_t *handle, uint16_t count);
+
+/**
+ * @brief Find the first stored item equal to element. Consumer side only.
+ *
+ * Searches both spans in place (memchr for single byte elements), nothing is removed.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[in] element pointer to the value to look for, typeSize bytes.
+ * @returns position of the item counted from the read position, or -1 if not found or error.
+ */
+int32_t adt_cbuffer_spscFind(Adt_CBufferSpsc_t *handle, const void *element);
+
+/**
+ * @brief Drop every item stored before the first one equal to element. Consumer side only.
+ *
+ * If element is not stored at all the buffer is emptied, so a burst of garbage is discarded in
+ * one call instead of one poll per item.
+ *
+ * @param[in] handle pointer to an allocated and initialized buffer struct.
+ * @param[in] element pointer to the value to look for, typeSize bytes.
+ * @returns number of items dropped, or -1 if uninitialized or error.
+ */
+int32_t adt_cbuffer_spscSkipUntil(Adt_CBufferSpsc_t *handle, const void *element);
+
 ///
 ///
 /// NOTE: Below structures and objects are private, and should not be used
@@ -108,4 +270,21 @@ typedef struct Adt_CBuffer_t_
     uint8_t endOfBuffer;
 } Adt_CBuffer_t;
 
+typedef struct Adt_CBufferSpsc_t_
+{
+    uint8_t *buffer;
+
+    uint32_t head; // Free running element index, written by the producer only
+    uint32_t tail; // Free running element index, written by the consumer only
+
+    Adt_InitState_e initState;
+
+    uint16_t length;
+    uint16_t mask;
+    uint8_t dataTypeSize;
+} Adt_CBufferSpsc_t;
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
 #endif /* ADT_CBUFFER_H_ */
@@ -0,0 +1,106 @@
+#ifndef ADT_RING_H_
+#define ADT_RING_H_
+
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
+#include "adt_cbuffer.h"
+#include "adt_codes.h"
+#include <stdint.h>
+
+/*
+ * C shim for adt::Ring<uint8_t, ADT_RING8_SIZE> (adt_ring.hpp)
+ *
+ * Byte ring with the same single-producer/single-consumer contract and zero-copy spans as
+ * Adt_CBufferSpsc_t, but with the size and element type fixed at compile time.
+ */
+
+#define ADT_RING8_SIZE 1024 // Must be a power of two
+
+/**
+ * @brief Storage for a byte ring, opaque to C.
+ *
+ * Sized and aligned for the C++ object, which is checked at compile time in adt_ring.cpp.
+ */
+typedef struct Adt_Ring8_t_
+{
+    uint32_t storage[(ADT_RING8_SIZE / sizeof(uint32_t)) + 2];
+} Adt_Ring8_t;
+
+/**
+ * @brief Initialize the ring, must complete before producer and consumer start using it.
+ *
+ * @param[in] handle pointer to the ring storage.
+ * @returns ADT_OK on success or ADT_ERROR on bad parameters.
+ */
+Adt_Result_e adt_ring8_init(Adt_Ring8_t *handle);
+
+/**
+ * @brief Number of stored bytes, see adt_cbuffer_spscGetLength(...).
+ */
+uint32_t adt_ring8_getLength(const Adt_Ring8_t *handle);
+
+/**
+ * @brief Push bytes, producer side only, see adt_cbuffer_spscPush(...).
+ *
+ * Counts are 32 bit here, a count larger than the ring fails with ADT_OVERFLOW instead of being
+ * truncated.
+ */
+Adt_Result_e adt_ring8_push(Adt_Ring8_t *handle, const uint8_t *data, uint32_t count);
+
+/**
+ * @brief Read and remove bytes, consumer side only, see adt_cbuffer_spscPoll(...).
+ */
+Adt_Result_e adt_ring8_poll(Adt_Ring8_t *handle, uint8_t *data, uint32_t count);
+
+/**
+ * @brief Read the first byte without removing it, consumer side only.
+ */
+Adt_Result_e adt_ring8_peek(Adt_Ring8_t *handle, uint8_t *data);
+
+/**
+ * @brief Drop everything currently stored, consumer side only.
+ */
+Adt_Result_e adt_ring8_reset(Adt_Ring8_t *handle);
+
+/**
+ * @brief Claim contiguous free space, see adt_cbuffer_spscClaimWrite(...).
+ */
+Adt_Result_e adt_ring8_claimWrite(Adt_Ring8_t *handle, Adt_CBufferSpan_t *span);
+
+/**
+ * @brief Publish bytes written into a claimed region, see adt_cbuffer_spscCommitWrite(...).
+ */
+Adt_Result_e adt_ring8_commitWrite(Adt_Ring8_t *handle, uint32_t count);
+
+/**
+ * @brief Look at stored bytes in place, see adt_cbuffer_spscPeekContiguous(...).
+ *
+ * @returns number of stored bytes.
+ */
+uint32_t adt_ring8_peekContiguous(Adt_Ring8_t *handle, Adt_CBufferSpan_t spans[2]);
+
+/**
+ * @brief Remove bytes without copying, see adt_cbuffer_spscRelease(...).
+ */
+Adt_Result_e adt_ring8_release(Adt_Ring8_t *handle, uint32_t count);
+
+/**
+ * @brief Position of the first stored byte equal to value, see adt_cbuffer_spscFind(...).
+ *
+ * @returns position counted from the read position, or -1 if not found.
+ */
+int32_t adt_ring8_find(Adt_Ring8_t *handle, uint8_t value);
+
+/**
+ * @brief Drop every byte before the first one equal to value, see adt_cbuffer_spscSkipUntil(...).
+ *
+ * @returns number of bytes dropped.
+ */
+uint32_t adt_ring8_skipUntil(Adt_Ring8_t *handle, uint8_t value);
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
+#endif /* ADT_RING_H_ */
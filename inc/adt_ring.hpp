@@ -0,0 +1,247 @@
+#ifndef ADT_RING_HPP_
+#define ADT_RING_HPP_
+
+#include "adt_codes.h"
+#include <stdint.h>
+#include <string.h>
+
+namespace adt
+{
+
+/**
+ * @brief Compile-time sized ring buffer
+ *
+ * Typed counterpart of Adt_CBufferSpsc_t. N is a power of two so positions are masked and element
+ * size is a compile-time constant, no division or end-of-buffer pointer arithmetic at run time.
+ * Same single-producer/single-consumer contract: the producer only writes head_, the consumer only
+ * writes tail_, each published with release and observed with acquire ordering.
+ *
+ * T must be trivially copyable. The object has no constructor so it can live in zero-initialized
+ * static storage; call reset() once before producer and consumer start.
+ */
+template <typename T, uint32_t N>
+class Ring
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Ring size must be a power of two");
+
+public:
+    struct Span
+    {
+        T *data;
+        uint32_t count;
+    };
+
+    static constexpr uint32_t capacity = N;
+
+    void reset()
+    {
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&tail_, head, __ATOMIC_RELEASE);
+    }
+
+    uint32_t length() const
+    {
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        return head - tail;
+    }
+
+    Adt_Result_e push(const T *items, uint32_t count)
+    {
+        if (!items || !count)
+            return ADT_ERROR;
+
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        if ((head - tail) + count > N)
+            return ADT_OVERFLOW;
+
+        uint32_t index = head & mask;
+        uint32_t chunk = N - index;
+        if (count <= chunk)
+        { // No wraparound
+            memcpy(&buffer_[index], items, count * sizeof(T));
+        }
+        else
+        {
+            memcpy(&buffer_[index], items, chunk * sizeof(T));
+            memcpy(&buffer_[0], items + chunk, (count - chunk) * sizeof(T));
+        }
+        __atomic_store_n(&head_, head + count, __ATOMIC_RELEASE);
+
+        return ADT_OK;
+    }
+
+    Adt_Result_e push(const T &item)
+    {
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        if ((head - tail) >= N)
+            return ADT_OVERFLOW;
+
+        buffer_[head & mask] = item;
+        __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+
+        return ADT_OK;
+    }
+
+    Adt_Result_e poll(T *items, uint32_t count)
+    {
+        if (!items || !count)
+            return ADT_ERROR;
+
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        uint32_t available = head - tail;
+        if (available < count)
+            return available ? ADT_UNDERRUN : ADT_EMPTY;
+
+        uint32_t index = tail & mask;
+        uint32_t chunk = N - index;
+        if (count <= chunk)
+        { // No wraparound
+            memcpy(items, &buffer_[index], count * sizeof(T));
+        }
+        else
+        {
+            memcpy(items, &buffer_[index], chunk * sizeof(T));
+            memcpy(items + chunk, &buffer_[0], (count - chunk) * sizeof(T));
+        }
+        __atomic_store_n(&tail_, tail + count, __ATOMIC_RELEASE);
+
+        return ADT_OK;
+    }
+
+    Adt_Result_e peek(T &item) const
+    {
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            return ADT_EMPTY;
+
+        item = buffer_[tail & mask];
+
+        return ADT_OK;
+    }
+
+    // Zero-copy producer side, see adt_cbuffer_spscClaimWrite(...)
+    Span claimWrite()
+    {
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        uint32_t space = N - (head - tail);
+        uint32_t untilEnd = N - (head & mask);
+
+        return Span{&buffer_[head & mask], space < untilEnd ? space : untilEnd};
+    }
+
+    Adt_Result_e commitWrite(uint32_t count)
+    {
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        if (!count)
+            return ADT_ERROR;
+        if ((head - tail) + count > N)
+            return ADT_OVERFLOW;
+
+        __atomic_store_n(&head_, head + count, __ATOMIC_RELEASE);
+
+        return ADT_OK;
+    }
+
+    // Zero-copy consumer side, see adt_cbuffer_spscPeekContiguous(...)
+    uint32_t peekContiguous(Span spans[2])
+    {
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        uint32_t available = head - tail;
+        uint32_t untilEnd = N - (tail & mask);
+
+        spans[0].data = &buffer_[tail & mask];
+        spans[1].data = &buffer_[0];
+        spans[0].count = available <= untilEnd ? available : untilEnd;
+        spans[1].count = available - spans[0].count;
+
+        return available;
+    }
+
+    Adt_Result_e release(uint32_t count)
+    {
+        uint32_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        uint32_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        uint32_t available = head - tail;
+        if (!count)
+            return ADT_ERROR;
+        if (available < count)
+            return available ? ADT_UNDERRUN : ADT_EMPTY;
+
+        __atomic_store_n(&tail_, tail + count, __ATOMIC_RELEASE);
+
+        return ADT_OK;
+    }
+
+    // Position of the first stored item equal to item, or -1, see adt_cbuffer_spscFind(...)
+    int32_t find(const T &item)
+    {
+        Span spans[2];
+        peekContiguous(spans);
+
+        return findInSpans(spans, item);
+    }
+
+    // Drop everything before the first item equal to item, see adt_cbuffer_spscSkipUntil(...)
+    uint32_t skipUntil(const T &item)
+    {
+        Span spans[2];
+        uint32_t available = peekContiguous(spans);
+        int32_t position = findInSpans(spans, item);
+
+        uint32_t dropped = (position < 0) ? available : static_cast<uint32_t>(position);
+        if (dropped)
+            release(dropped);
+
+        return dropped;
+    }
+
+private:
+    static constexpr uint32_t mask = N - 1;
+
+    static int32_t findInSpan(const Span &span, const T &item)
+    {
+        if constexpr (sizeof(T) == 1)
+        {
+            const void *match = memchr(span.data, *reinterpret_cast<const uint8_t *>(&item), span.count);
+            return match ? static_cast<int32_t>(static_cast<const T *>(match) - span.data) : -1;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < span.count; ++i)
+            {
+                if (!memcmp(&span.data[i], &item, sizeof(T)))
+                    return static_cast<int32_t>(i);
+            }
+            return -1;
+        }
+    }
+
+    static int32_t findInSpans(const Span spans[2], const T &item)
+    {
+        int32_t position = findInSpan(spans[0], item);
+        if (position < 0 && spans[1].count)
+        {
+            position = findInSpan(spans[1], item);
+            if (position >= 0)
+                position += spans[0].count;
+        }
+
+        return position;
+    }
+
+    T buffer_[N];
+    uint32_t head_; // Free running element index, written by the producer only
+    uint32_t tail_; // Free running element index, written by the consumer only
+};
+
+} // namespace adt
+
+#endif /* ADT_RING_HPP_ */
@@ -0,0 +1,20 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
+/**
+ * @brief Measure the hot paths and log the results.
+ *
+ * Covers cbuffer/ring push+poll, checksums and reply frame decoding, all on private buffers and
+ * decoder state. Built into the application when configured with -DBENCHMARK=ON and runs before the
+ * hook is connected, or on a Linux host from host/CMakeLists.txt.
+ */
+void benchmark_run(void);
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
+#endif
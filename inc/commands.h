@@ -2,6 +2,7 @@
 #define _COMMANDS_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef enum Command_e_
 {
@@ -14,6 +15,7 @@ typedef enum Command_e_
     COMMAND_HOOK_MID_CLOSE = 136,
     COMMAND_HOOK_OPEN = 144,
     COMMAND_HOOK_MID_OPEN = 152,
+    COMMAND_HOOK_WAYPOINT = 160, // parameter1 is the waypoint index
 } Command_e;
 
 typedef enum CommandState_e_
@@ -38,15 +40,29 @@ typedef struct CommandObject_t_
 {
     Command_e operation;
     CommandState_e state;
-    uint32_t timer;
+    uint32_t started; // k_uptime_get_32() when the command was taken from the buffer
+    int32_t parameter1;
     CommandState_e (*task)(struct CommandObject_t_ *);
+    void (*abort)(struct CommandObject_t_ *); // Optional, called when a stop preempts the task
 } CommandObject_t;
 
 void command_addToBuffer(CommandInput_t *cmd);
 uint8_t command_isInExecution(void);
 void command_run(void);
+
+// Wall-clock timing for command tasks, independent of how often command_run() is called
+typedef uint32_t CommandDeadline_t;
+uint32_t command_elapsed(const CommandObject_t *cmdObject);
+CommandDeadline_t command_deadlineIn(uint32_t milliseconds);
+bool command_isExpired(CommandDeadline_t deadline);
+// Drops the running command and the queue, main thread only like command_run()
 void command_flush(void);
 
+// Priority lane: preempts the running command and drops the queue, callable from any thread
+void command_requestStop(void);
+// Request to the stop frame handed to the BLE TX queue (not on air yet), in microseconds
+void command_getStopLatency(uint32_t *last, uint32_t *worst);
+
 CommandState_e executeCmdTaskHoming(CommandObject_t *);
 CommandState_e executeCmdTaskEack(CommandObject_t *);
 CommandState_e executeCmdTaskStop(CommandObject_t *);
@@ -55,5 +71,7 @@ CommandState_e executeCmdClose(CommandObject_t *);
 CommandState_e executeCmdMidClose(CommandObject_t *);
 CommandState_e executeCmdMidOpen(CommandObject_t *);
 CommandState_e executeCmdOpen(CommandObject_t *);
+CommandState_e executeCmdWaypoint(CommandObject_t *);
+void abortCmdTaskHoming(CommandObject_t *);
 
 #endif
\ No newline at end of file
@@ -1,7 +1,12 @@
 #ifndef _COMMUNICATIONS_H_
 #define _COMMUNICATIONS_H_
 
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
 #include <stdint.h>
+#include "adt_cbuffer.h"
 
 void comm_init(void);
 
@@ -9,5 +14,11 @@ void comm_addToMotorBuffer(const uint8_t *const data, uint32_t length);
 void comm_removeFromMotorBuffer(uint8_t *buffer, uint32_t length);
 uint32_t comm_getAvailableMotorDataLength(void);
 uint8_t comm_peekFromMotorBuffer(void);
+uint32_t comm_peekMotorData(Adt_CBufferSpan_t spans[2]);
+void comm_releaseMotorData(uint32_t length);
+uint32_t comm_skipMotorDataUntil(uint8_t value);
 
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
 #endif
\ No newline at end of file
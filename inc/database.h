@@ -1,6 +1,10 @@
 #ifndef _DATABASE_H_
 #define _DATABASE_H_
 
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -23,6 +27,23 @@ typedef enum HookTarget_e_
     HOOK_TARGET_OPEN,
 } HookTarget_e;
 
+#define DATABASE_MIN_WAYPOINTS 3
+#define DATABASE_MAX_WAYPOINTS 8
+#define DATABASE_WAYPOINT_NAME_LENGTH 8
+
+/**
+ * @brief Named hook position
+ *
+ * A position within tolerance counts as being at the waypoint. The table is sorted by position and
+ * the bands must not overlap, see database_setWaypoints(...).
+ */
+typedef struct DatabaseWaypoint_t_
+{
+    char name[DATABASE_WAYPOINT_NAME_LENGTH];
+    uint16_t position;
+    uint16_t tolerance;
+} DatabaseWaypoint_t;
+
 typedef enum Errors_e_
 {
     ERROR_NONE,
@@ -49,8 +70,38 @@ typedef enum CurrentLimitValues_e_
     CURRENT_LIMIT_OPERATION,
 } CurrentLimitValues_e;
 
+/**
+ * @brief Consistent copy of the telemetry shared with other threads
+ *
+ * The main thread is the only writer. Readers in any thread get all fields from the same update
+ * without locks, see database_getSnapshot(...).
+ */
+typedef struct DatabaseSnapshot_t_
+{
+    uint32_t sequence; // Increases with every published update
+    uint16_t position;
+    int16_t current;  // mA
+    uint16_t voltage; // mV
+    uint8_t error;
+    bool stopped;
+} DatabaseSnapshot_t;
+
+// Calibrated values as built into the firmware, before storage applies anything
+typedef struct DatabaseCalibration_t_
+{
+    uint16_t midPosition;
+    uint16_t openPosition;
+    int16_t homingSpeed;
+    int16_t closingSpeed;
+    int16_t openingSpeed;
+} DatabaseCalibration_t;
+
 void database_run(void);
+void database_getSnapshot(DatabaseSnapshot_t *snapshot);
+uint32_t database_getDiscardedBytes(void);
+uint32_t database_getSkippedSamples(void);
 
+void database_getDefaultCalibration(DatabaseCalibration_t *calibration);
 int16_t database_getHomingSpeed(void);
 bool database_setHomingSpeed(int16_t);
 int16_t database_getClosingSpeed(void);
@@ -61,6 +112,13 @@ uint8_t database_getReplySeqNo(void);
 uint8_t database_getNextSeqNo(void);
 
 uint16_t database_convertTargetToValue(HookTarget_e);
+int32_t database_convertTargetToWaypoint(HookTarget_e target);
+bool database_setWaypoints(const DatabaseWaypoint_t *table, uint32_t count);
+uint32_t database_getWaypointCount(void);
+const DatabaseWaypoint_t *database_getWaypoint(uint32_t index);
+int32_t database_findWaypoint(uint16_t position);
+bool database_setTargetValue(HookTarget_e target, uint16_t value);
+uint16_t database_getPosition(void);
 HookState_e database_getState(void);
 uint8_t database_isAtEndStroke(void);
 bool database_isProtectionTriggered(void);
@@ -75,7 +133,14 @@ void database_eackError(void);
 uint8_t database_isReadyForLifting(void);
 
 void database_resetPosition(void);
+void database_resetTelemetry(void);
+bool database_hasTelemetry(void);
 void database_printHookPosition(void);
 bool database_isStopped(void);
+int32_t database_getVelocity(void);     // counts/s, filtered
+int32_t database_getAcceleration(void); // counts/s^2, filtered
 
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
 #endif
\ No newline at end of file
@@ -65,7 +65,230 @@ bool encoding_isFletcher16ChecksumValidWithSeed(const uint8_t *rxData,
  */
 bool encoding_isFletcher16ChecksumValid(const uint8_t *rxData, uint32_t bytes, uint16_t rxChecksum);
 
+/**
+ * @brief Merge two independently calculated Fletcher16 checksums
+ *
+ * Gives the checksum of A followed by B from the checksum of A, the checksum of B and the length of
+ * B, in constant time. Unlike seed chaining the two parts do not have to be calculated in order,
+ * e.g. the header can be checksummed where it is received and the payload later in the main loop.
+ * Same result as encoding_calculateFletcher16ChecksumWithSeed(B, lengthB, checksumA).
+ *
+ * @param checksumA checksum of the first part, may itself be seeded or combined
+ * @param checksumB checksum of the second part, calculated with seed 0
+ * @param lengthB number of bytes in the second part
+ * @return uint16_t checksum of both parts
+ */
+uint16_t encoding_fletcher16Combine(uint16_t checksumA, uint16_t checksumB, uint32_t lengthB);
+
+/**
+ * @brief Running Fletcher16 state for data that is not contiguous or not all available yet
+ *
+ * Built on the seed chaining described above: feeding the data in any number of pieces gives the
+ * same result as encoding_calculateFletcher16ChecksumWithSeed(...) over the whole data, e.g. a
+ * frame split in two spans of a ring buffer or arriving in several notifications.
+ */
+typedef struct Encoding_Fletcher16Ctx_t_
+{
+    uint16_t checksum;
+} Encoding_Fletcher16Ctx_t;
+
+/**
+ * @brief Start a new running checksum
+ *
+ * @param ctx pointer to the context
+ * @param seed starting point for checksum calculations, 0 for a plain checksum
+ */
+void encoding_fletcher16Init(Encoding_Fletcher16Ctx_t *ctx, uint16_t seed);
+
+/**
+ * @brief Add the next piece of data to a running checksum
+ *
+ * @param ctx pointer to an initialized context
+ * @param data pointer to data, may be NULL if bytes is 0
+ * @param bytes number of bytes, 0 leaves the checksum untouched
+ */
+void encoding_fletcher16Update(Encoding_Fletcher16Ctx_t *ctx, const uint8_t *data, uint32_t bytes);
+
+/**
+ * @brief Checksum of everything added so far
+ *
+ * The context is not modified, more data can still be added afterwards.
+ *
+ * @param ctx pointer to an initialized context
+ * @return uint16_t checksum
+ */
+uint16_t encoding_fletcher16Final(const Encoding_Fletcher16Ctx_t *ctx);
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, not reflected, no final xor)
+ *
+ * Table driven, 4 bytes per iteration (slicing-by-4), tables are constant and live in flash.
+ *
+ * @param data pointer to data
+ * @param bytes number of bytes
+ * @param seed CRC to continue from, ENCODING_CRC16_INIT for a new calculation. Passing the result
+ * of the first part of a split buffer continues the calculation over the second part.
+ *
+ * @return uint16_t crc
+ */
+uint16_t encoding_calculateCrc16ChecksumWithSeed(const uint8_t *data, uint32_t bytes, uint16_t seed);
+
+/**
+ * @brief CRC-16/CCITT-FALSE starting from ENCODING_CRC16_INIT
+ *
+ * @param data pointer to data
+ * @param bytes number of bytes
+ *
+ * @return uint16_t crc
+ */
+uint16_t encoding_calculateCrc16Checksum(const uint8_t *data, uint32_t bytes);
+
+#define ENCODING_CRC16_INIT 0xFFFF
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected, as used by zlib/ethernet)
+ *
+ * Table driven, 8 bytes per iteration (slicing-by-8), tables are constant and live in flash.
+ *
+ * @param data pointer to data
+ * @param bytes number of bytes
+ * @param seed CRC to continue from, 0 for a new calculation. Passing the result of the first part
+ * of a split buffer continues the calculation over the second part.
+ *
+ * @return uint32_t crc
+ */
+uint32_t encoding_calculateCrc32ChecksumWithSeed(const uint8_t *data, uint32_t bytes, uint32_t seed);
+
+/**
+ * @brief CRC-32 starting from 0
+ *
+ * @param data pointer to data
+ * @param bytes number of bytes
+ *
+ * @return uint32_t crc
+ */
+uint32_t encoding_calculateCrc32Checksum(const uint8_t *data, uint32_t bytes);
+
+/*
+ * Link checksum
+ *
+ * Checksum protecting the frames exchanged with the hook, picked at build time with
+ * ENCODING_LINK_CHECKSUM. The trailer of every frame is sizeof(Encoding_LinkChecksum_t) bytes,
+ * little endian. Both sides of the link have to be built with the same selection.
+ */
+#define ENCODING_LINK_FLETCHER16 0
+#define ENCODING_LINK_CRC16 1
+#define ENCODING_LINK_CRC32 2
+
+#ifndef ENCODING_LINK_CHECKSUM
+#define ENCODING_LINK_CHECKSUM ENCODING_LINK_FLETCHER16
+#endif
+
+#if ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC32
+typedef uint32_t Encoding_LinkChecksum_t;
+#elif (ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC16) || (ENCODING_LINK_CHECKSUM == ENCODING_LINK_FLETCHER16)
+typedef uint16_t Encoding_LinkChecksum_t;
+#else
+#error "Unknown ENCODING_LINK_CHECKSUM"
+#endif
+
+/**
+ * @brief Running link checksum, see Encoding_Fletcher16Ctx_t
+ */
+typedef struct Encoding_LinkCtx_t_
+{
+    Encoding_LinkChecksum_t checksum;
+} Encoding_LinkCtx_t;
+
+void encoding_linkInit(Encoding_LinkCtx_t *ctx);
+void encoding_linkUpdate(Encoding_LinkCtx_t *ctx, const uint8_t *data, uint32_t bytes);
+Encoding_LinkChecksum_t encoding_linkFinal(const Encoding_LinkCtx_t *ctx);
+
+/**
+ * @brief Link checksum of a contiguous buffer
+ *
+ * @param data pointer to data
+ * @param bytes number of bytes
+ *
+ * @return link checksum
+ */
+Encoding_LinkChecksum_t encoding_calculateLinkChecksum(const uint8_t *data, uint32_t bytes);
+
 #ifdef __cplusplus
 } // AUTO-EXTERN_C
+
+namespace encoding
+{
+
+/**
+ * @brief Compile-time Fletcher16
+ *
+ * Same result as encoding_calculateFletcher16ChecksumWithSeed(...), meant for constant data such
+ * as fixed frames that can be checksummed by the compiler instead of at run time.
+ */
+constexpr uint16_t fletcher16(const uint8_t *data, uint32_t bytes, uint16_t seed = 0)
+{
+    if (data == nullptr || bytes == 0)
+        return 0;
+
+    uint32_t c0 = seed & 0xff;
+    uint32_t c1 = (seed & 0xff00) >> 8;
+    for (uint32_t i = 0; i < bytes; ++i)
+    {
+        c0 = (c0 + data[i]) % 255;
+        c1 = (c1 + c0) % 255;
+    }
+    return static_cast<uint16_t>(c1 << 8 | c0);
+}
+
+/**
+ * @brief Compile-time CRC-16/CCITT-FALSE, same result as encoding_calculateCrc16ChecksumWithSeed(...)
+ */
+constexpr uint16_t crc16(const uint8_t *data, uint32_t bytes, uint16_t seed = ENCODING_CRC16_INIT)
+{
+    uint16_t crc = seed;
+    for (uint32_t i = 0; i < bytes; ++i)
+    {
+        crc ^= static_cast<uint16_t>(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Compile-time CRC-32, same result as encoding_calculateCrc32ChecksumWithSeed(...)
+ */
+constexpr uint32_t crc32(const uint8_t *data, uint32_t bytes, uint32_t seed = 0)
+{
+    uint32_t crc = ~seed;
+    for (uint32_t i = 0; i < bytes; ++i)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Compile-time link checksum, same result as encoding_calculateLinkChecksum(...)
+ */
+constexpr Encoding_LinkChecksum_t linkChecksum(const uint8_t *data, uint32_t bytes)
+{
+#if ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC32
+    return crc32(data, bytes);
+#elif ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC16
+    return crc16(data, bytes);
+#else
+    return fletcher16(data, bytes);
+#endif
+}
+
+} // namespace encoding
 #endif
 #endif /* CHECKSUM_H_ */
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef _HOOK_DECODER_H_
+#define _HOOK_DECODER_H_
+
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
+#include "encoding_checksum.h"
+#include <stdint.h>
+
+/*
+ * Hook reply framing and incremental decoder
+ *
+ * [0xFE][type][stdReply_t][link checksum over header, type and reply, little endian]
+ *
+ * No state outside the HookDecoder_t it is given, so the database and the benchmark can each
+ * decode their own stream.
+ */
+
+#pragma pack(push, 1)
+typedef struct stdReply_t_
+{
+    uint16_t voltage; // mV
+    int16_t current;  // mA
+    uint16_t position;
+    uint8_t error;
+    struct
+    {
+        uint8_t sequenceNumber : 3;
+        uint8_t dataType : 1;
+        uint8_t dataNumber : 4;
+    } command;
+    uint8_t dataValues[4];
+
+} stdReply_t;
+
+#define SIZE_OF_STDREPLY sizeof(stdReply_t)
+
+typedef struct HookReply_t_
+{
+    uint8_t header;
+    uint8_t type;
+    stdReply_t data;
+    Encoding_LinkChecksum_t checksum; // Fletcher16 unless built with another ENCODING_LINK_CHECKSUM
+} HookReply_t;
+
+#define SIZE_OF_HOOKREPLY sizeof(HookReply_t)
+#pragma pack(pop)
+
+#define HOOK_REPLY_HEADER 0xFE
+
+typedef enum HookDecoderState_e_
+{
+    HOOK_DECODER_SYNC,     // Waiting for the header byte
+    HOOK_DECODER_HEADER,   // Waiting for the reply type
+    HOOK_DECODER_PAYLOAD,  // Collecting stdReply_t
+    HOOK_DECODER_CHECKSUM, // Collecting the checksum trailer
+} HookDecoderState_e;
+
+typedef enum HookDecoderResult_e_
+{
+    HOOK_DECODER_NONE,
+    HOOK_DECODER_FRAME,
+    HOOK_DECODER_CORRUPT,
+} HookDecoderResult_e;
+
+typedef struct HookDecoder_t_
+{
+    HookDecoderState_e state;
+    uint32_t index;   // Bytes of the current frame received so far
+    uint32_t checked; // Bytes of the current frame already added to ctx
+    Encoding_LinkCtx_t ctx;
+    HookReply_t reply;
+} HookDecoder_t;
+
+/**
+ * @brief Start decoding a new stream, waiting for a header
+ *
+ * @param decoder pointer to the decoder
+ */
+void hookDecoder_init(HookDecoder_t *decoder);
+
+/**
+ * @brief Advance the decoder over the next contiguous bytes of the stream
+ *
+ * Stops right after the last byte of a frame so the caller can use decoder->reply before it is
+ * overwritten. The checksum is accumulated once per chunk as the bytes come in, so a complete frame
+ * is validated without another pass over it.
+ *
+ * @param decoder pointer to the decoder
+ * @param data bytes of the stream
+ * @param length number of bytes in data
+ * @param consumed set to the number of bytes used, the rest belongs to the next call
+ * @return HOOK_DECODER_FRAME or HOOK_DECODER_CORRUPT when a frame completed, HOOK_DECODER_NONE otherwise
+ */
+HookDecoderResult_e hookDecoder_feed(HookDecoder_t *decoder, const uint8_t *data, uint32_t length, uint32_t *consumed);
+
+/**
+ * @brief Restart decoding after a corrupt frame
+ *
+ * The header may have been a data byte, so a real frame can start inside the rejected one. Its
+ * bytes are already out of the caller's buffer, replay them from the next candidate header on.
+ *
+ * @param decoder pointer to the decoder that returned HOOK_DECODER_CORRUPT
+ * @return number of bytes of the rejected frame that were dropped
+ */
+uint32_t hookDecoder_resync(HookDecoder_t *decoder);
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
+#endif
@@ -7,6 +7,7 @@
 void remote_init(void);
 void remote_updateUi(void);
 void remote_disconnectedUi(void);
+void remote_disconnected(void);
 void remote_updateButtons(uint32_t button_state, uint32_t has_changed);
 void remote_updateHookState(HookState_e state);
 void remote_run(void);
@@ -19,6 +19,7 @@ typedef enum Parameters_e_
     PARAMETER_CURRENT_PIN_CONFIG,
     PARAMETER_IGNORE_SENSOR,
 
+    PARAMETER_COUNT, // Number of parameters, keep last
 } Parameters_e;
 
 void mc_moveTo(int16_t target, int16_t speed, uint8_t seqNo);
@@ -27,9 +28,18 @@ void mc_setPositionUninitialized(void);
 void mc_eack(void);
 void mc_stop(void);
 void mc_reboot(void);
-void mc_setIgnoreSensorParameter(uint8_t ignore);
-void mc_setCurrentLimitParameter(uint16_t value);
+
+// Parameter setters return true when a write was sent, false when the cached value already matched
+bool mc_setIgnoreSensorParameter(uint8_t ignore);
+bool mc_setCurrentLimitParameter(uint16_t value);
+bool mc_setHardwareCurrentLimiter(bool enable);
 void mc_readParameter(Parameters_e number);
-void mc_setHardwareCurrentLimiter(bool enable);
+
+// Parameter cache, filled from read replies only: mc_readParameters() and the read back after each write.
+// Dropped on reboot, on disconnect and when a reply reports an uninitialized position.
+void mc_readParameters(void);
+void mc_updateParameter(Parameters_e number, int32_t value);
+bool mc_getParameter(Parameters_e number, int32_t *value);
+void mc_invalidateParameters(void);
 
 #endif
\ No newline at end of file
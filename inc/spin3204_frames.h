@@ -0,0 +1,61 @@
+#ifndef _SPIN3204_FRAMES_H_
+#define _SPIN3204_FRAMES_H_
+
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
+#include "encoding_checksum.h"
+#include <stdint.h>
+
+/*
+ * SPIN3204 request framing
+ *
+ * [0xFE][RemoteCommand_t][link checksum over header and command, little endian]
+ */
+
+#define SPIN_FRAME_HEADER 0xFE
+
+typedef enum SpinCommand_e_
+{
+    SPIN_COMMAND_NONE,
+    SPIN_COMMAND_MOVE,
+    // Reserved from 1 to 9
+    SPIN_COMMAND_STOP = 10,
+    SPIN_COMMAND_EACK,
+    SPIN_COMMAND_REBOOT,
+    SPIN_COMMAND_SET_POSITION,
+    SPIN_COMMAND_SET_PARAMETER,
+    SPIN_COMMAND_READ_PARAMETER,
+    SPIN_COMMAND_READY_FOR_LOADING,
+} SpinCommand_e;
+
+#pragma pack(push, 1)
+typedef struct RemoteCommand_t_
+{
+    uint8_t operation;
+    int16_t Parameter1;
+    int16_t Parameter2;
+    int16_t Parameter3;
+
+} RemoteCommand_t;
+#pragma pack(pop)
+
+#define SPIN_FRAME_SIZE (1 + sizeof(RemoteCommand_t) + sizeof(Encoding_LinkChecksum_t))
+
+typedef struct SpinFrame_t_
+{
+    uint8_t bytes[SPIN_FRAME_SIZE];
+} SpinFrame_t;
+
+// Fixed requests, built and checksummed at compile time (spin3204_frames.cpp)
+extern const SpinFrame_t spin_frameStop;
+extern const SpinFrame_t spin_frameEack;
+extern const SpinFrame_t spin_frameReboot;
+extern const SpinFrame_t spin_frameSetPositionHome;
+extern const SpinFrame_t spin_frameSetPositionUninitialized;
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
+#endif
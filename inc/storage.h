@@ -0,0 +1,52 @@
+#ifndef _STORAGE_H_
+#define _STORAGE_H_
+
+#ifdef __cplusplus
+extern "C" { // AUTO-EXTERN_C
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Warm start data kept in flash through the settings subsystem
+ *
+ * Homed state, last resting position and the identity of the hook they belong to, with the target
+ * positions and speeds that differ from the firmware defaults. Values still at their defaults are
+ * not stored, so a firmware update can change them. Loaded by settings_load(), which also applies
+ * the stored calibration and speeds to the database, together with a site waypoint table when one was provisioned under hook/waypoints.
+ * The GATT cache of the hook lives next to it under hook/gatt and is deleted with the bond of the
+ * hook. Changes are written behind by the system work queue, at most once every
+ * STORAGE_WRITE_DELAY_MS and only when the content differs from what is already stored.
+ */
+
+#define STORAGE_PEER_SIZE 7 // bt_addr_le_t
+#define STORAGE_GATT_HASH_SIZE 16
+
+// NUS handles of a bonded hook, valid for as long as its GATT database hash stays the same
+#pragma pack(push, 1)
+typedef struct StorageGattCache_t_
+{
+    uint8_t peer[STORAGE_PEER_SIZE];
+    uint8_t hash[STORAGE_GATT_HASH_SIZE];
+    uint16_t rx;
+    uint16_t tx;
+    uint16_t txCcc;
+    uint8_t rxProperties;
+} StorageGattCache_t;
+#pragma pack(pop)
+
+void storage_setPeer(const uint8_t *peer, uint32_t length);
+void storage_saveHomed(void);
+void storage_clearHomed(void);
+void storage_savePosition(uint16_t position);
+bool storage_isWarmStartValid(uint16_t livePosition);
+void storage_saveGattCache(const StorageGattCache_t *cache);
+bool storage_getGattCache(StorageGattCache_t *cache);
+// Drops the cache when it belongs to peer, or whatever peer it belongs to if peer is NULL
+void storage_clearGattCache(const uint8_t *peer, uint32_t length);
+
+#ifdef __cplusplus
+} // AUTO-EXTERN_C
+#endif
+#endif
@@ -5,9 +5,11 @@
 
 void system_init(const void *lcd_dev, const void *cs_dev);
 void system_updateUi(uint8_t connected);
+// Blocks until new telemetry arrives or the next 25ms period starts, then processes it
 void system_thread(void);
 void system_receiveUpdate(const uint8_t *data, uint32_t length);
 void system_updateButtons(uint32_t button_state, uint32_t has_changed);
 void system_setRssi(int8_t rssi);
+void system_setPeer(const uint8_t *peer, uint32_t length);
 
 #endif
\ No newline at end of file
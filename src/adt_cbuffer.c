@@ -256,3 +256,333 @@ static Adt_Result_e read_cbuffer(Adt_CBuffer_t *handle,
         return ADT_OK;
     }
 }
+
+/*
+ * SPSC variant
+ *
+ * head and tail count elements and are never wrapped, only masked when used as an offset, so
+ * head - tail is the stored length even after the counters overflow. Each side reads its own
+ * index relaxed (nobody else writes it) and the other side's index with acquire, then publishes
+ * its own update with release after the data copy is done.
+ */
+
+static void spsc_copyIn(Adt_CBufferSpsc_t *handle, uint32_t index, const uint8_t *data, uint32_t count)
+{
+    uint32_t offset = (index & handle->mask) * handle->dataTypeSize;
+    uint32_t writeSize = count * handle->dataTypeSize;
+    uint32_t chunkSize = handle->length * handle->dataTypeSize - offset;
+
+    if (writeSize <= chunkSize)
+    { // No wraparound
+        memcpy(&handle->buffer[offset], data, writeSize);
+    }
+    else
+    {
+        memcpy(&handle->buffer[offset], data, chunkSize);
+        memcpy(handle->buffer, data + chunkSize, writeSize - chunkSize);
+    }
+}
+
+static void spsc_copyOut(const Adt_CBufferSpsc_t *handle, uint32_t index, uint8_t *data, uint32_t count)
+{
+    uint32_t offset = (index & handle->mask) * handle->dataTypeSize;
+    uint32_t readSize = count * handle->dataTypeSize;
+    uint32_t chunkSize = handle->length * handle->dataTypeSize - offset;
+
+    if (readSize <= chunkSize)
+    { // No wraparound
+        memcpy(data, &handle->buffer[offset], readSize);
+    }
+    else
+    {
+        memcpy(data, &handle->buffer[offset], chunkSize);
+        memcpy(data + chunkSize, handle->buffer, readSize - chunkSize);
+    }
+}
+
+Adt_Result_e adt_cbuffer_spscInit(Adt_CBufferSpsc_t *handle, void *buffer, uint8_t size, uint16_t length)
+{
+    if (!handle || !buffer || !size || length < 2 || (length & (length - 1)))
+    {
+        if (handle) // Set unintialized if possible.
+        {
+            handle->initState = ADT_UNINITIALIZED;
+        }
+
+        return ADT_ERROR;
+    }
+
+    handle->buffer = (uint8_t *)buffer;
+    handle->dataTypeSize = size;
+    handle->length = length;
+    handle->mask = length - 1;
+    memset(handle->buffer, 0, size * length);
+
+    __atomic_store_n(&handle->head, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&handle->tail, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&handle->initState, ADT_INITIALIZED, __ATOMIC_RELEASE);
+    return ADT_OK;
+}
+
+int32_t adt_cbuffer_spscGetLength(const Adt_CBufferSpsc_t *handle)
+{
+    if (!handle || __atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return -1;
+    }
+
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+
+    return (int32_t)(head - tail);
+}
+
+Adt_Result_e adt_cbuffer_spscPush(Adt_CBufferSpsc_t *handle, const void *const buffer, uint16_t count)
+{
+    // Assert
+    if (!handle || !buffer || !count)
+    {
+        return ADT_ERROR;
+    }
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_ACQUIRE);
+    if ((head - tail) + count > handle->length)
+    {
+        return ADT_OVERFLOW;
+    }
+
+    spsc_copyIn(handle, head, (const uint8_t *)buffer, count);
+    __atomic_store_n(&handle->head, head + count, __ATOMIC_RELEASE);
+
+    return ADT_OK;
+}
+
+Adt_Result_e adt_cbuffer_spscPoll(Adt_CBufferSpsc_t *handle, void *buffer, uint16_t count)
+{
+    // Assert
+    if (!handle || !buffer || !count)
+    {
+        return ADT_ERROR;
+    }
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+    uint32_t available = head - tail;
+    if (available < count)
+    {
+        return available ? ADT_UNDERRUN : ADT_EMPTY;
+    }
+
+    spsc_copyOut(handle, tail, (uint8_t *)buffer, count);
+    __atomic_store_n(&handle->tail, tail + count, __ATOMIC_RELEASE);
+
+    return ADT_OK;
+}
+
+Adt_Result_e adt_cbuffer_spscPeek(Adt_CBufferSpsc_t *handle, void *buffer)
+{
+    // Assert
+    if (!handle || !buffer)
+    {
+        return ADT_ERROR;
+    }
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+    if (head == tail)
+    {
+        return ADT_EMPTY;
+    }
+
+    spsc_copyOut(handle, tail, (uint8_t *)buffer, 1);
+
+    return ADT_OK;
+}
+
+Adt_Result_e adt_cbuffer_spscReset(Adt_CBufferSpsc_t *handle)
+{
+    if (!handle || __atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+        return ADT_ERROR;
+
+    // Consumer can only move its own index, catch up with whatever the producer published.
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&handle->tail, head, __ATOMIC_RELEASE);
+
+    return ADT_OK;
+}
+
+Adt_Result_e adt_cbuffer_spscClaimWrite(Adt_CBufferSpsc_t *handle, Adt_CBufferSpan_t *span)
+{
+    // Assert
+    if (!handle || !span)
+    {
+        return ADT_ERROR;
+    }
+    span->data = NULL;
+    span->count = 0;
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_ACQUIRE);
+    uint32_t space = handle->length - (head - tail);
+    uint32_t untilEnd = handle->length - (head & handle->mask);
+
+    span->data = &handle->buffer[(head & handle->mask) * handle->dataTypeSize];
+    span->count = (uint16_t)(space < untilEnd ? space : untilEnd);
+
+    return span->count ? ADT_OK : ADT_OUT_OF_SPACE;
+}
+
+Adt_Result_e adt_cbuffer_spscCommitWrite(Adt_CBufferSpsc_t *handle, uint16_t count)
+{
+    // Assert
+    if (!handle || !count)
+    {
+        return ADT_ERROR;
+    }
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_ACQUIRE);
+    if ((head - tail) + count > handle->length)
+    {
+        return ADT_OVERFLOW;
+    }
+
+    __atomic_store_n(&handle->head, head + count, __ATOMIC_RELEASE);
+
+    return ADT_OK;
+}
+
+int32_t adt_cbuffer_spscPeekContiguous(Adt_CBufferSpsc_t *handle, Adt_CBufferSpan_t spans[2])
+{
+    if (!handle || !spans || __atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return -1;
+    }
+
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+    uint32_t available = head - tail;
+    uint32_t untilEnd = handle->length - (tail & handle->mask);
+
+    spans[0].data = &handle->buffer[(tail & handle->mask) * handle->dataTypeSize];
+    spans[1].data = handle->buffer;
+    if (available <= untilEnd)
+    { // No wraparound
+        spans[0].count = (uint16_t)available;
+        spans[1].count = 0;
+    }
+    else
+    {
+        spans[0].count = (uint16_t)untilEnd;
+        spans[1].count = (uint16_t)(available - untilEnd);
+    }
+
+    return (int32_t)available;
+}
+
+Adt_Result_e adt_cbuffer_spscRelease(Adt_CBufferSpsc_t *handle, uint16_t count)
+{
+    // Assert
+    if (!handle || !count)
+    {
+        return ADT_ERROR;
+    }
+    if (__atomic_load_n(&handle->initState, __ATOMIC_ACQUIRE) == ADT_UNINITIALIZED)
+    {
+        return ADT_NOT_READY;
+    }
+
+    uint32_t tail = __atomic_load_n(&handle->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&handle->head, __ATOMIC_ACQUIRE);
+    uint32_t available = head - tail;
+    if (available < count)
+    {
+        return available ? ADT_UNDERRUN : ADT_EMPTY;
+    }
+
+    __atomic_store_n(&handle->tail, tail + count, __ATOMIC_RELEASE);
+
+    return ADT_OK;
+}
+
+static int32_t spsc_findInSpan(const Adt_CBufferSpsc_t *handle, const Adt_CBufferSpan_t *span, const uint8_t *element)
+{
+    if (handle->dataTypeSize == 1)
+    {
+        const uint8_t *match = memchr(span->data, *element, span->count);
+        return match ? (int32_t)(match - span->data) : -1;
+    }
+
+    for (uint16_t i = 0; i < span->count; ++i)
+    {
+        if (!memcmp(&span->data[i * handle->dataTypeSize], element, handle->dataTypeSize))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int32_t adt_cbuffer_spscFind(Adt_CBufferSpsc_t *handle, const void *element)
+{
+    Adt_CBufferSpan_t spans[2];
+
+    if (!element || adt_cbuffer_spscPeekContiguous(handle, spans) <= 0)
+    {
+        return -1;
+    }
+
+    int32_t position = spsc_findInSpan(handle, &spans[0], (const uint8_t *)element);
+    if (position < 0 && spans[1].count)
+    {
+        position = spsc_findInSpan(handle, &spans[1], (const uint8_t *)element);
+        if (position >= 0)
+        {
+            position += spans[0].count;
+        }
+    }
+
+    return position;
+}
+
+int32_t adt_cbuffer_spscSkipUntil(Adt_CBufferSpsc_t *handle, const void *element)
+{
+    Adt_CBufferSpan_t spans[2];
+
+    int32_t available = adt_cbuffer_spscPeekContiguous(handle, spans);
+    if (!element || available < 0)
+    {
+        return -1;
+    }
+
+    int32_t position = adt_cbuffer_spscFind(handle, element);
+    int32_t dropped = (position < 0) ? available : position;
+    if (dropped)
+    {
+        adt_cbuffer_spscRelease(handle, (uint16_t)dropped);
+    }
+
+    return dropped;
+}
@@ -0,0 +1,126 @@
+#include "adt_ring.h"
+#include "adt_ring.hpp"
+#include <new>
+
+using Ring8 = adt::Ring<uint8_t, ADT_RING8_SIZE>;
+
+static_assert(sizeof(Ring8) <= sizeof(Adt_Ring8_t), "Adt_Ring8_t storage too small");
+static_assert(alignof(Ring8) <= alignof(Adt_Ring8_t), "Adt_Ring8_t storage misaligned");
+
+// The Ring8 constructed in the storage by adt_ring8_init(...)
+static inline Ring8 *ring(Adt_Ring8_t *handle)
+{
+    return std::launder(reinterpret_cast<Ring8 *>(handle->storage));
+}
+
+static inline const Ring8 *ring(const Adt_Ring8_t *handle)
+{
+    return std::launder(reinterpret_cast<const Ring8 *>(handle->storage));
+}
+
+Adt_Result_e adt_ring8_init(Adt_Ring8_t *handle)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    new (handle->storage) Ring8(); // Value initialized, empty
+    return ADT_OK;
+}
+
+uint32_t adt_ring8_getLength(const Adt_Ring8_t *handle)
+{
+    return handle ? ring(handle)->length() : 0;
+}
+
+Adt_Result_e adt_ring8_push(Adt_Ring8_t *handle, const uint8_t *data, uint32_t count)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    return (count == 1 && data) ? ring(handle)->push(*data) : ring(handle)->push(data, count);
+}
+
+Adt_Result_e adt_ring8_poll(Adt_Ring8_t *handle, uint8_t *data, uint32_t count)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    return ring(handle)->poll(data, count);
+}
+
+Adt_Result_e adt_ring8_peek(Adt_Ring8_t *handle, uint8_t *data)
+{
+    if (handle == nullptr || data == nullptr)
+        return ADT_ERROR;
+
+    return ring(handle)->peek(*data);
+}
+
+Adt_Result_e adt_ring8_reset(Adt_Ring8_t *handle)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    ring(handle)->reset();
+    return ADT_OK;
+}
+
+Adt_Result_e adt_ring8_claimWrite(Adt_Ring8_t *handle, Adt_CBufferSpan_t *span)
+{
+    if (handle == nullptr || span == nullptr)
+        return ADT_ERROR;
+
+    Ring8::Span claimed = ring(handle)->claimWrite();
+    span->data = claimed.data;
+    span->count = static_cast<uint16_t>(claimed.count);
+
+    return claimed.count ? ADT_OK : ADT_OUT_OF_SPACE;
+}
+
+Adt_Result_e adt_ring8_commitWrite(Adt_Ring8_t *handle, uint32_t count)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    return ring(handle)->commitWrite(count);
+}
+
+uint32_t adt_ring8_peekContiguous(Adt_Ring8_t *handle, Adt_CBufferSpan_t spans[2])
+{
+    if (handle == nullptr || spans == nullptr)
+        return 0;
+
+    Ring8::Span view[2];
+    uint32_t length = ring(handle)->peekContiguous(view);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        spans[i].data = view[i].data;
+        spans[i].count = static_cast<uint16_t>(view[i].count);
+    }
+
+    return length;
+}
+
+Adt_Result_e adt_ring8_release(Adt_Ring8_t *handle, uint32_t count)
+{
+    if (handle == nullptr)
+        return ADT_ERROR;
+
+    return ring(handle)->release(count);
+}
+
+int32_t adt_ring8_find(Adt_Ring8_t *handle, uint8_t value)
+{
+    if (handle == nullptr)
+        return -1;
+
+    return ring(handle)->find(value);
+}
+
+uint32_t adt_ring8_skipUntil(Adt_Ring8_t *handle, uint8_t value)
+{
+    if (handle == nullptr)
+        return 0;
+
+    return ring(handle)->skipUntil(value);
+}
@@ -0,0 +1,330 @@
+#include "benchmark.h"
+#include "adt_cbuffer.h"
+#include "adt_ring.hpp"
+#include "encoding_checksum.h"
+#include "hook_decoder.h"
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+#define BENCHMARK_TICK_UNIT "cycles"
+#else
+#include <atomic>
+#include <chrono>
+#define BENCHMARK_TICK_UNIT "ns" // Host build, ticks are nanoseconds
+#endif
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#define LOG_MODULE_NAME benchmark
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#define BENCHMARK_ITERATIONS 1000
+#define BENCHMARK_RING_LENGTH 1024
+#define BENCHMARK_MAX_CHECKSUM_SIZE (64 * 1024)
+#define BENCHMARK_FRAMES_PER_RUN (BENCHMARK_RING_LENGTH / sizeof(HookReply_t)) // Fits in the ring
+#define BENCHMARK_FRAME_RUNS 50
+
+typedef struct Element16_t_
+{
+    uint8_t bytes[16];
+} Element16_t;
+
+static uint8_t payload[BENCHMARK_MAX_CHECKSUM_SIZE];
+static uint8_t cbufferStorage[BENCHMARK_RING_LENGTH];
+static Adt_CBuffer_t cbuffer;
+static Adt_CBufferSpsc_t spsc;
+static adt::Ring<uint8_t, BENCHMARK_RING_LENGTH> ring8;
+static adt::Ring<Element16_t, BENCHMARK_RING_LENGTH / sizeof(Element16_t)> ring16;
+static HookDecoder_t frameDecoder; // Private, the live database is not touched
+#ifdef __ZEPHYR__
+static struct k_spinlock cbufferLock;
+#else
+static std::atomic_flag cbufferLock = ATOMIC_FLAG_INIT;
+#endif
+static volatile uint32_t sink;
+
+// Returns elapsed timer ticks, see report(...) for the conversion to time
+template <typename F>
+static uint64_t measure(F &&body)
+{
+#ifdef __ZEPHYR__
+    timing_t start = timing_counter_get();
+    body();
+    timing_t end = timing_counter_get();
+
+    return timing_cycles_get(&start, &end);
+#else
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+#endif
+}
+
+static uint64_t report(const char *name, uint32_t bytes, uint32_t operations, uint64_t cycles)
+{
+#ifdef __ZEPHYR__
+    uint64_t ns = timing_cycles_to_ns(cycles);
+#else
+    uint64_t ns = cycles;
+#endif
+    if (ns == 0)
+    {
+        ns = 1;
+    }
+    uint32_t nsPerOperation = static_cast<uint32_t>(ns / operations);
+    uint32_t kBytesPerSecond = static_cast<uint32_t>((uint64_t)bytes * operations * 1000000ULL / ns);
+
+    LOG_INF("%s %u B: %u ns/op, %u KB/s", name, bytes, nsPerOperation, kBytesPerSecond);
+
+    return ns;
+}
+
+// Runs body under cbufferLock, what a shared cbuffer costs without the SPSC API
+template <typename F>
+static void locked(F &&body)
+{
+#ifdef __ZEPHYR__
+    k_spinlock_key_t key = k_spin_lock(&cbufferLock);
+    body();
+    k_spin_unlock(&cbufferLock, key);
+#else
+    while (cbufferLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    body();
+    cbufferLock.clear(std::memory_order_release);
+#endif
+}
+
+// Checksums are compared per byte, in hundredths of a timer tick
+static void reportChecksum(const char *name, uint32_t bytes, uint32_t operations, uint64_t cycles)
+{
+    report(name, bytes, operations, cycles);
+
+    uint32_t centiCyclesPerByte = static_cast<uint32_t>(cycles * 100 / ((uint64_t)bytes * operations));
+    LOG_INF("%s %u B: %u.%02u " BENCHMARK_TICK_UNIT "/B", name, bytes, centiCyclesPerByte / 100,
+            centiCyclesPerByte % 100);
+}
+
+static void benchmarkBuffers(void)
+{
+    static const uint16_t chunks[] = {1, 4, 16, 64};
+    uint8_t chunk[64] = {0};
+
+    for (uint16_t size : chunks)
+    {
+        adt_cbuffer_init(&cbuffer, cbufferStorage, sizeof(uint8_t), BENCHMARK_RING_LENGTH);
+        uint64_t cycles = measure([&] {
+            for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+            {
+                adt_cbuffer_push(&cbuffer, chunk, size);
+                adt_cbuffer_poll(&cbuffer, chunk, size);
+            }
+        });
+        report("cbuffer push/poll", size, BENCHMARK_ITERATIONS, cycles);
+
+        // The locked baseline and the SPSC API are compared warm, each runs once untimed
+        auto lockedRun = [&] {
+            for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+            {
+                locked([&] { adt_cbuffer_push(&cbuffer, chunk, size); });
+                locked([&] { adt_cbuffer_poll(&cbuffer, chunk, size); });
+            }
+        };
+        adt_cbuffer_init(&cbuffer, cbufferStorage, sizeof(uint8_t), BENCHMARK_RING_LENGTH);
+        lockedRun();
+        uint64_t lockedNs = report("cbuffer+lock push/poll", size, BENCHMARK_ITERATIONS, measure(lockedRun));
+
+        auto spscRun = [&] {
+            for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+            {
+                adt_cbuffer_spscPush(&spsc, chunk, size);
+                adt_cbuffer_spscPoll(&spsc, chunk, size);
+            }
+        };
+        adt_cbuffer_spscInit(&spsc, cbufferStorage, sizeof(uint8_t), BENCHMARK_RING_LENGTH);
+        spscRun();
+        uint64_t spscNs = report("spsc push/poll", size, BENCHMARK_ITERATIONS, measure(spscRun));
+        LOG_INF("spsc vs cbuffer+lock %u B: %u%% of the time", size, static_cast<uint32_t>(spscNs * 100 / lockedNs));
+
+        ring8.reset();
+        cycles = measure([&] {
+            for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+            {
+                ring8.push(chunk, size);
+                ring8.poll(chunk, size);
+            }
+        });
+        report("ring8 push/poll", size, BENCHMARK_ITERATIONS, cycles);
+    }
+
+    // 16-byte elements, one element per operation
+    Element16_t element = {};
+    adt_cbuffer_init(&cbuffer, cbufferStorage, sizeof(Element16_t), BENCHMARK_RING_LENGTH / sizeof(Element16_t));
+    uint64_t cycles = measure([&] {
+        for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        {
+            adt_cbuffer_push(&cbuffer, &element, 1);
+            adt_cbuffer_poll(&cbuffer, &element, 1);
+        }
+    });
+    report("cbuffer16 push/poll", sizeof(Element16_t), BENCHMARK_ITERATIONS, cycles);
+
+    ring16.reset();
+    cycles = measure([&] {
+        for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        {
+            ring16.push(element);
+            ring16.poll(&element, 1);
+        }
+    });
+    report("ring16 push/poll", sizeof(Element16_t), BENCHMARK_ITERATIONS, cycles);
+    sink = element.bytes[0];
+}
+
+// Byte-per-iteration Fletcher16 the word-at-a-time kernel replaced, kept as the baseline
+static uint16_t fletcher16Bytewise(const uint8_t *data, uint32_t bytes)
+{
+    uint32_t c0 = 0;
+    uint32_t c1 = 0;
+
+    while (bytes > 0)
+    {
+        uint32_t blocklen = bytes > 5802 ? 5802 : bytes;
+        bytes -= blocklen;
+        do
+        {
+            c0 += *data++;
+            c1 += c0;
+        } while (--blocklen);
+        c0 %= 255;
+        c1 %= 255;
+    }
+    return static_cast<uint16_t>(c1 << 8 | c0);
+}
+
+static void benchmarkChecksum(void)
+{
+    for (uint32_t i = 0; i < sizeof(payload); ++i)
+    {
+        payload[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    for (uint32_t size = 16; size <= BENCHMARK_MAX_CHECKSUM_SIZE; size *= 4)
+    {
+        uint32_t iterations = (size >= 4096) ? 10 : 100;
+        uint64_t cycles = measure([&] {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                sink = encoding_calculateFletcher16Checksum(payload, size);
+            }
+        });
+        reportChecksum("fletcher16", size, iterations, cycles);
+
+        cycles = measure([&] {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                sink = fletcher16Bytewise(payload, size);
+            }
+        });
+        reportChecksum("fletcher16 bytewise", size, iterations, cycles);
+
+        cycles = measure([&] {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                sink = encoding_calculateCrc16Checksum(payload, size);
+            }
+        });
+        reportChecksum("crc16", size, iterations, cycles);
+
+        cycles = measure([&] {
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                sink = encoding_calculateCrc32Checksum(payload, size);
+            }
+        });
+        reportChecksum("crc32", size, iterations, cycles);
+    }
+}
+
+// Same loop as database_run(), on the benchmark's own ring and decoder
+static uint32_t decodeFrames(void)
+{
+    adt::Ring<uint8_t, BENCHMARK_RING_LENGTH>::Span spans[2];
+    uint32_t frames = 0;
+
+    while (ring8.peekContiguous(spans))
+    {
+        if (frameDecoder.state == HOOK_DECODER_SYNC)
+        {
+            ring8.skipUntil(HOOK_REPLY_HEADER);
+            if (!ring8.peekContiguous(spans))
+                break;
+        }
+
+        uint32_t consumed;
+        HookDecoderResult_e result = hookDecoder_feed(&frameDecoder, spans[0].data, spans[0].count, &consumed);
+        ring8.release(consumed);
+
+        if (result == HOOK_DECODER_FRAME)
+        {
+            ++frames;
+        }
+        else if (result == HOOK_DECODER_CORRUPT)
+        {
+            hookDecoder_resync(&frameDecoder);
+        }
+    }
+
+    return frames;
+}
+
+static void benchmarkFrames(void)
+{
+    // HookReply_t: header, type, voltage, current, position, error, command, values, checksum
+    uint8_t frame[sizeof(HookReply_t)] = {HOOK_REPLY_HEADER, 0x00, 0x30, 0x75, 0x00, 0x00, 0xFF, 0x7F};
+    Encoding_LinkChecksum_t fcs = encoding_calculateLinkChecksum(frame, sizeof(frame) - sizeof(fcs));
+    memcpy(&frame[sizeof(frame) - sizeof(fcs)], &fcs, sizeof(fcs));
+
+    ring8.reset();
+    hookDecoder_init(&frameDecoder);
+    uint32_t decoded = 0;
+    uint64_t cycles = measure([&] {
+        for (uint32_t run = 0; run < BENCHMARK_FRAME_RUNS; ++run)
+        {
+            for (uint32_t i = 0; i < BENCHMARK_FRAMES_PER_RUN; ++i)
+            {
+                ring8.push(frame, sizeof(frame));
+            }
+            decoded += decodeFrames();
+        }
+    });
+
+    uint32_t frames = BENCHMARK_FRAME_RUNS * BENCHMARK_FRAMES_PER_RUN;
+    uint64_t ns = report("frame push+decode", sizeof(frame), frames, cycles);
+    LOG_INF("frames/s: %u", static_cast<uint32_t>((uint64_t)frames * 1000000000ULL / (ns ? ns : 1)));
+    if (decoded != frames)
+    {
+        LOG_WRN("Decoded %u of %u frames", decoded, frames);
+    }
+}
+
+void benchmark_run(void)
+{
+#ifdef __ZEPHYR__
+    timing_init();
+    timing_start();
+#endif
+
+    benchmarkBuffers();
+    benchmarkChecksum();
+    benchmarkFrames();
+
+#ifdef __ZEPHYR__
+    timing_stop();
+#endif
+}
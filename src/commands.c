@@ -2,12 +2,13 @@
 #include "database.h"
 #include <zephyr/logging/log.h>
 #include <memory.h>
+#include <zephyr/kernel.h>
 #include "remote.h"
 
 #define LOG_MODULE_NAME commands
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
-#define TIMEOUT_COMMAND 1000
+#define TIMEOUT_COMMAND_MS 25000
 #define MAX_NUMBER_OF_COMMANDS 8
 static CommandInput_t cmdBuffer[MAX_NUMBER_OF_COMMANDS];
 static int32_t cmdIdxStore = 0; // Head
@@ -16,8 +17,17 @@ static int32_t cmdCount = 0;
 static CommandInput_t *cmd = NULL;
 static CommandObject_t cmdObject;
 
+static CommandInput_t stopCommand = {.operation = COMMAND_STOP};
+static bool stopPending = false;
+static uint32_t stopRequestedAt = 0; // k_cycle_get_32() of the first pending request
+static uint32_t stopLatencyLast = 0;
+static uint32_t stopLatencyWorst = 0;
+static struct k_spinlock stopLock;
+
 static CommandInput_t *process(CommandInput_t *cmd, CommandObject_t *cmdObject);
 static CommandInput_t *requestStop(void);
+static bool takeStopRequest(uint32_t *requestedAt);
+static void preempt(uint32_t requestedAt);
 
 uint8_t command_isInExecution(void)
 {
@@ -45,15 +55,65 @@ void command_flush(void)
     cmdCount = 0;
     cmdIdxUse = 0;
     cmdIdxStore = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&stopLock);
+    stopPending = false;
+    k_spin_unlock(&stopLock, key);
+}
+
+void command_requestStop(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&stopLock);
+    if (!stopPending)
+    {
+        stopPending = true;
+        stopRequestedAt = k_cycle_get_32();
+    }
+    k_spin_unlock(&stopLock, key);
+}
+
+void command_getStopLatency(uint32_t *last, uint32_t *worst)
+{
+    k_spinlock_key_t key = k_spin_lock(&stopLock);
+    *last = stopLatencyLast;
+    *worst = stopLatencyWorst;
+    k_spin_unlock(&stopLock, key);
+}
+
+uint32_t command_elapsed(const CommandObject_t *cmdObject)
+{
+    return k_uptime_get_32() - cmdObject->started;
+}
+
+CommandDeadline_t command_deadlineIn(uint32_t milliseconds)
+{
+    return k_uptime_get_32() + milliseconds;
+}
+
+bool command_isExpired(CommandDeadline_t deadline)
+{
+    // Signed difference, stays correct when the 32 bit uptime wraps
+    return (int32_t)(k_uptime_get_32() - deadline) >= 0;
 }
 
 void command_run(void)
 {
+    uint32_t requestedAt;
+
+    if (takeStopRequest(&requestedAt))
+    {
+        preempt(requestedAt);
+
+        return;
+    }
+
     if (cmdCount != 0 && cmd == NULL)
     {
         cmdObject.state = COMMAND_STATE_START;
-        cmdObject.timer = 0;
+        cmdObject.started = k_uptime_get_32();
+        cmdObject.abort = NULL;
         cmd = &cmdBuffer[cmdIdxUse];
+        cmdObject.parameter1 = cmd->parameter1;
         cmdIdxUse = (cmdIdxUse + 1) % MAX_NUMBER_OF_COMMANDS;
         --cmdCount;
 
@@ -66,6 +126,7 @@ void command_run(void)
         case COMMAND_HOMING:
             cmdObject.operation = cmd->operation;
             cmdObject.task = executeCmdTaskHoming;
+            cmdObject.abort = abortCmdTaskHoming;
 
             break;
         case COMMAND_EACK:
@@ -102,6 +163,11 @@ void command_run(void)
             cmdObject.operation = cmd->operation;
             cmdObject.task = executeCmdMidOpen;
 
+            break;
+        case COMMAND_HOOK_WAYPOINT:
+            cmdObject.operation = cmd->operation;
+            cmdObject.task = executeCmdWaypoint;
+
             break;
         default:
 
@@ -113,15 +179,20 @@ void command_run(void)
     {
         cmd = process(cmd, &cmdObject);
     }
+
+    // A stop raised by the checks in process() does not wait for the next call either
+    if (takeStopRequest(&requestedAt))
+    {
+        preempt(requestedAt);
+    }
 }
 
 static CommandInput_t *process(CommandInput_t *cmd, CommandObject_t *cmdObject)
 {
-    ++cmdObject->timer;
     CommandInput_t *result = cmd;
     CommandState_e state = cmdObject->task(cmdObject);
 
-    if (cmdObject->timer > TIMEOUT_COMMAND)
+    if (command_elapsed(cmdObject) > TIMEOUT_COMMAND_MS)
     {
         database_setError(ERROR_COMMAND_TIMEOUT);
         result = requestStop();
@@ -147,10 +218,57 @@ static CommandInput_t *process(CommandInput_t *cmd, CommandObject_t *cmdObject)
     return result;
 }
 
+// Keeps the command running, command_run() aborts it through the priority lane right after
 static CommandInput_t *requestStop(void)
 {
     remote_updateHookState(HOOK_STATE_ERROR);
-    CommandInput_t cmd = {.operation = COMMAND_STOP};
-    command_addToBuffer(&cmd);
-    return NULL;
+    command_requestStop();
+    return cmd;
+}
+
+static bool takeStopRequest(uint32_t *requestedAt)
+{
+    k_spinlock_key_t key = k_spin_lock(&stopLock);
+    bool result = stopPending;
+    stopPending = false;
+    *requestedAt = stopRequestedAt;
+    k_spin_unlock(&stopLock, key);
+
+    return result;
+}
+
+// Drops the queue, sends the stop in this same call and only then aborts whatever ran
+static void preempt(uint32_t requestedAt)
+{
+    // The abort hook may queue frames of its own, they must not get ahead of the stop
+    CommandObject_t preempted = cmdObject;
+    bool aborted = cmd && cmdObject.operation != COMMAND_STOP;
+
+    cmdCount = 0;
+    cmdIdxUse = 0;
+    cmdIdxStore = 0;
+
+    cmdObject.operation = COMMAND_STOP;
+    cmdObject.state = COMMAND_STATE_START;
+    cmdObject.started = k_uptime_get_32();
+    cmdObject.task = executeCmdTaskStop;
+    cmdObject.abort = NULL;
+    cmd = process(&stopCommand, &cmdObject);
+
+    // Measured up to the hand-off to the BLE TX queue, not to the radio
+    uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() - requestedAt);
+    k_spinlock_key_t key = k_spin_lock(&stopLock);
+    stopLatencyLast = latency;
+    stopLatencyWorst = (latency > stopLatencyWorst) ? latency : stopLatencyWorst;
+    k_spin_unlock(&stopLock, key);
+    LOG_INF("Stop queued for BLE %u us after request", latency);
+
+    if (aborted)
+    {
+        LOG_WRN("Command %d preempted by stop", preempted.operation);
+        if (preempted.abort)
+        {
+            preempted.abort(&preempted);
+        }
+    }
 }
\ No newline at end of file
@@ -2,12 +2,22 @@
 #include "database.h"
 #include "spin3204_control.h"
 #include "remote.h"
+#include "storage.h"
 
 #include <zephyr/logging/log.h>
 #define LOG_MODULE_NAME cmd_task
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
-static int32_t timeout = 0;
+#define SETTLE_PARAMETERS_MS 500 // Motor controller applying written parameters
+#define SETTLE_EACK_MS 500       // Overload acknowledge during homing
+#define SETTLE_CLOSED_MS 750     // Hook resting closed before the command finishes
+#define EACK_LOCAL_MS 1000       // Error acknowledge, local first
+#define EACK_HOOK_MS 2000        // then on the hook
+#define STOP_RETRY_MS 250
+#define JAM_CHECK_MS 2500        // Stopped without reaching the target for this long is a jam
+
+static CommandDeadline_t deadline = 0;
+static bool parametersWritten = false; // Skip the settle time when the parameters were already set
 
 CommandState_e executeCmdTaskHoming(CommandObject_t *cmdObject)
 {
@@ -22,6 +32,7 @@ CommandState_e executeCmdTaskHoming(CommandObject_t *cmdObject)
         else
         {
             mc_setPositionUninitialized();
+            storage_clearHomed();
             LOG_INF("Reset position");
             cmdObject->state = COMMAND_STATE_SETUP;
         }
@@ -45,13 +56,13 @@ CommandState_e executeCmdTaskHoming(CommandObject_t *cmdObject)
             LOG_INF("Overload error detected");
             mc_eack();
             database_eackError();
-            timeout = cmdObject->timer + 20;
+            deadline = command_deadlineIn(SETTLE_EACK_MS);
             cmdObject->state = COMMAND_STATE_TEARDOWN;
         }
 
         break;
     case COMMAND_STATE_TEARDOWN:
-        if(timeout < cmdObject->timer)
+        if (command_isExpired(deadline))
         {
             if (database_getError() == ERROR_NONE)
             {
@@ -69,6 +80,7 @@ CommandState_e executeCmdTaskHoming(CommandObject_t *cmdObject)
     case COMMAND_STATE_END:
         remote_updateHookState(HOOK_STATE_CLOSED);
         database_resetPosition();
+        storage_saveHomed();
 
         mc_setIgnoreSensorParameter(0);
 
@@ -86,6 +98,13 @@ CommandState_e executeCmdTaskHoming(CommandObject_t *cmdObject)
     return cmdObject->state;
 }
 
+void abortCmdTaskHoming(CommandObject_t *cmdObject)
+{
+    // Sensor protection back on, the hook stays unhomed
+    mc_setIgnoreSensorParameter(0);
+    LOG_INF("Homing aborted");
+}
+
 CommandState_e executeCmdTaskEack(CommandObject_t *cmdObject)
 {
     switch (cmdObject->state)
@@ -97,7 +116,7 @@ CommandState_e executeCmdTaskEack(CommandObject_t *cmdObject)
 
         break;
     case COMMAND_STATE_SETUP:
-        if (cmdObject->timer > 40)
+        if (command_elapsed(cmdObject) > EACK_LOCAL_MS)
         {
             if (database_getError() == ERROR_NONE)
             {
@@ -115,7 +134,7 @@ CommandState_e executeCmdTaskEack(CommandObject_t *cmdObject)
 
         break;
     case COMMAND_STATE_ACTION:
-        if (cmdObject->timer > 80)
+        if (command_elapsed(cmdObject) > EACK_HOOK_MS)
         {
             if (database_getError() == ERROR_NONE)
             {
@@ -150,16 +169,10 @@ CommandState_e executeCmdTaskStop(CommandObject_t *cmdObject)
 {
     switch (cmdObject->state)
     {
-    case COMMAND_STATE_START:
-        cmdObject->state = COMMAND_STATE_ACTION;
-
-        break;
-    case COMMAND_STATE_SETUP:
-
-        break;
+    case COMMAND_STATE_START: // Straight to sending, a preempting stop goes out in the same call
     case COMMAND_STATE_ACTION:
         mc_stop();
-        timeout = cmdObject->timer + 10;
+        deadline = command_deadlineIn(STOP_RETRY_MS);
         LOG_INF("Sent stop request...");
         cmdObject->state = COMMAND_STATE_TEARDOWN;
 
@@ -169,7 +182,7 @@ CommandState_e executeCmdTaskStop(CommandObject_t *cmdObject)
         {
             cmdObject->state = COMMAND_STATE_FINISH;
         }
-        else if (timeout < cmdObject->timer)
+        else if (command_isExpired(deadline))
         {
             cmdObject->state = COMMAND_STATE_ACTION;
         }
@@ -229,12 +242,12 @@ CommandState_e executeCmdClose(CommandObject_t *cmdObject)
     switch (cmdObject->state)
     {
     case COMMAND_STATE_START:
-        mc_setHardwareCurrentLimiter(true);
+        parametersWritten = mc_setHardwareCurrentLimiter(true);
         cmdObject->state = COMMAND_STATE_SETUP;
 
         break;
     case COMMAND_STATE_SETUP:
-        if (cmdObject->timer > 20)
+        if (!parametersWritten || command_elapsed(cmdObject) > SETTLE_PARAMETERS_MS)
         {
             cmdObject->state = COMMAND_STATE_ACTION;
         }
@@ -251,12 +264,12 @@ CommandState_e executeCmdClose(CommandObject_t *cmdObject)
             mc_setPositionHome();
             database_resetPosition();
             cmdObject->state = COMMAND_STATE_END;
-            timeout = cmdObject->timer + 30;
+            deadline = command_deadlineIn(SETTLE_CLOSED_MS);
         }
 
         break;
     case COMMAND_STATE_END:
-        if (database_getState() == HOOK_STATE_CLOSED && timeout < cmdObject->timer)
+        if (database_getState() == HOOK_STATE_CLOSED && command_isExpired(deadline))
         {
             database_printHookPosition();
             cmdObject->state = COMMAND_STATE_FINISH;
@@ -272,27 +285,36 @@ CommandState_e executeCmdClose(CommandObject_t *cmdObject)
     return cmdObject->state;
 }
 
-static CommandState_e executeCmdMid(CommandObject_t *cmdObject, int16_t speed)
+static CommandState_e executeCmdMoveTo(CommandObject_t *cmdObject, int32_t waypoint, int16_t speed)
 {
+    const DatabaseWaypoint_t *target = database_getWaypoint(waypoint);
+
     switch (cmdObject->state)
     {
     case COMMAND_STATE_START:
-        mc_setCurrentLimitParameter(database_getCurrentAt(CURRENT_LIMIT_OPERATION));
+        if (!target)
+        {
+            LOG_WRN("Unknown waypoint %d", waypoint);
+            cmdObject->state = COMMAND_STATE_FINISH;
+
+            break;
+        }
+        parametersWritten = mc_setCurrentLimitParameter(database_getCurrentAt(CURRENT_LIMIT_OPERATION));
         cmdObject->state = COMMAND_STATE_SETUP;
 
         break;
     case COMMAND_STATE_SETUP:
-        mc_setHardwareCurrentLimiter(false);
+        parametersWritten |= mc_setHardwareCurrentLimiter(false);
         cmdObject->state = COMMAND_STATE_ACTION;
 
         break;
     case COMMAND_STATE_ACTION:
-        if (cmdObject->timer > 20)
+        if (!parametersWritten || command_elapsed(cmdObject) > SETTLE_PARAMETERS_MS)
         {
-            mc_moveTo(database_convertTargetToValue(HOOK_TARGET_MID), speed, database_getNextSeqNo());
-            LOG_INF("Send command mid...");
+            mc_moveTo(target->position, speed, database_getNextSeqNo());
+            LOG_INF("Send command %s...", target->name);
             cmdObject->state = COMMAND_STATE_END;
-            timeout = cmdObject->timer + 100;
+            deadline = command_deadlineIn(JAM_CHECK_MS);
         }
 
         break;
@@ -300,14 +322,14 @@ static CommandState_e executeCmdMid(CommandObject_t *cmdObject, int16_t speed)
 
         break;
     case COMMAND_STATE_END:
-        if (database_getState() == HOOK_STATE_MID)
+        if (database_findWaypoint(database_getPosition()) == waypoint)
         {
             database_printHookPosition();
             cmdObject->state = COMMAND_STATE_FINISH;
         }
-        else if (timeout < cmdObject->timer)
+        else if (command_isExpired(deadline))
         {
-            timeout = cmdObject->timer + 100;
+            deadline = command_deadlineIn(JAM_CHECK_MS);
             if (database_isStopped())
             {
                 database_setError(ERROR_MOTOR_JAMMED);
@@ -326,11 +348,20 @@ static CommandState_e executeCmdMid(CommandObject_t *cmdObject, int16_t speed)
 
 CommandState_e executeCmdMidClose(CommandObject_t *cmdObject)
 {
-    return executeCmdMid(cmdObject, database_getClosingSpeed());
+    return executeCmdMoveTo(cmdObject, database_convertTargetToWaypoint(HOOK_TARGET_MID), database_getClosingSpeed());
 }
 CommandState_e executeCmdMidOpen(CommandObject_t *cmdObject)
 {
-    return executeCmdMid(cmdObject, database_getOpeningSpeed());
+    return executeCmdMoveTo(cmdObject, database_convertTargetToWaypoint(HOOK_TARGET_MID), database_getOpeningSpeed());
+}
+
+CommandState_e executeCmdWaypoint(CommandObject_t *cmdObject)
+{
+    // Direction from where the hook is now, the same speeds as the fixed targets
+    const DatabaseWaypoint_t *target = database_getWaypoint(cmdObject->parameter1);
+    bool opening = target && (target->position > (database_getPosition() & 0x7FFF));
+
+    return executeCmdMoveTo(cmdObject, cmdObject->parameter1, opening ? database_getOpeningSpeed() : database_getClosingSpeed());
 }
 
 CommandState_e executeCmdOpen(CommandObject_t *cmdObject)
@@ -338,21 +369,21 @@ CommandState_e executeCmdOpen(CommandObject_t *cmdObject)
     switch (cmdObject->state)
     {
     case COMMAND_STATE_START:
-        mc_setCurrentLimitParameter(database_getCurrentAt(CURRENT_LIMIT_OPERATION));
+        parametersWritten = mc_setCurrentLimitParameter(database_getCurrentAt(CURRENT_LIMIT_OPERATION));
         cmdObject->state = COMMAND_STATE_SETUP;
 
         break;
     case COMMAND_STATE_SETUP:
-        mc_setHardwareCurrentLimiter(false);
+        parametersWritten |= mc_setHardwareCurrentLimiter(false);
         cmdObject->state = COMMAND_STATE_ACTION;
 
         break;
     case COMMAND_STATE_ACTION:
-        if (cmdObject->timer > 20)
+        if (!parametersWritten || command_elapsed(cmdObject) > SETTLE_PARAMETERS_MS)
         {
             mc_moveTo(database_convertTargetToValue(HOOK_TARGET_OPEN), database_getOpeningSpeed(), database_getNextSeqNo());
             cmdObject->state = COMMAND_STATE_END;
-            timeout = cmdObject->timer + 100;
+            deadline = command_deadlineIn(JAM_CHECK_MS);
         }
 
         break;
@@ -365,9 +396,9 @@ CommandState_e executeCmdOpen(CommandObject_t *cmdObject)
             database_printHookPosition();
             cmdObject->state = COMMAND_STATE_FINISH;
         }
-        else if (timeout < cmdObject->timer)
+        else if (command_isExpired(deadline))
         {
-            timeout = cmdObject->timer + 100;
+            deadline = command_deadlineIn(JAM_CHECK_MS);
             if (database_isStopped())
             {
                 database_setError(ERROR_MOTOR_JAMMED);
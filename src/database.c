@@ -1,42 +1,26 @@
 #include "database.h"
 #include "communications.h"
 #include "encoding_checksum.h"
+#include "hook_decoder.h"
+#include "spin3204_control.h"
 #include <memory.h>
+#include <stddef.h>
+#include <stdlib.h>
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
 #define LOG_MODULE_NAME database
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
-#pragma pack(1)
-typedef struct stdReply_t_
-{
-    uint16_t voltage; // mV
-    int16_t current;  // mA
-    uint16_t position;
-    uint8_t error;
-    struct
-    {
-        uint8_t sequenceNumber : 3;
-        uint8_t dataType : 1;
-        uint8_t dataNumber : 4;
-    } command;
-    uint8_t dataValues[4];
-
-} stdReply_t;
-
-#define SIZE_OF_STDREPLY sizeof(stdReply_t)
-
-#pragma pack(1)
-typedef struct HookReply_t_
-{
-    uint8_t header;
-    uint8_t type;
-    stdReply_t data;
-    uint16_t checksum;
-} HookReply_t;
-
-#define SIZE_OF_HOOKREPLY sizeof(HookReply_t)
+/*
+ * When replies back up (main loop stalled on the UI path), only the newest valid reply of a
+ * database_run() updates position, voltage, current and the derived velocity / stop detection.
+ * Errors and parameter reads are still taken from every reply. Set to 0 to replay every sample.
+ */
+#ifndef DATABASE_LATEST_TELEMETRY_ONLY
+#define DATABASE_LATEST_TELEMETRY_ONLY 1
+#endif
 
 typedef enum MotorDirection_e_
 {
@@ -50,10 +34,39 @@ typedef enum MotorDirection_e_
 #define HOOK_CLOSING_DIRECTION CW
 #define HOOK_OPENING_DIRECTION CCW
 
-static int32_t hookVelocityCounter = 0;
-static int32_t hookVelocity = 0;
-static uint16_t hookPreviousPosition = INT16_MAX;
+#define DATABASE_DEFAULT_MID_POSITION 13720
+#define DATABASE_DEFAULT_OPEN_POSITION 18293
+#define DATABASE_DEFAULT_HOMING_SPEED (HOOK_HOMING_DIRECTION * 1500)
+#define DATABASE_DEFAULT_CLOSING_SPEED (HOOK_CLOSING_DIRECTION * 4000)
+#define DATABASE_DEFAULT_OPENING_SPEED (HOOK_OPENING_DIRECTION * 2000)
+
+typedef struct TelemetrySample_t_
+{
+    uint32_t timestamp; // k_uptime ms when the reply was applied
+    uint16_t position;
+    int16_t current;
+    uint16_t voltage;
+} TelemetrySample_t;
+
+#define HOOK_ENCODER_MASK 0x7FFF // Bit 15 flags the end stroke, it is not part of the position
+
+#define DATABASE_HISTORY_LENGTH 16      // Power of two, a bit more than one stop window at 25 ms
+#define DATABASE_VELOCITY_WINDOW_MS 50  // Minimum time base for a velocity estimate
+#define DATABASE_FILTER_SHIFT 2         // IIR weight of a new estimate, 1/4
+#define DATABASE_FIXED_SHIFT 4          // Filtered values are kept with 4 fractional bits
+#define DATABASE_STOP_VELOCITY 1000     // counts/s, 25 counts per 25 ms sample before
+#define DATABASE_STOP_HOLD_MS 250       // Time below DATABASE_STOP_VELOCITY to count as stopped
+
+static TelemetrySample_t history[DATABASE_HISTORY_LENGTH];
+static uint32_t historyCount = 0;    // Free running, newest sample at historyCount - 1
+static uint32_t publishedCount = 0;  // historyCount at the last snapshot
+static int32_t hookVelocity = 0;     // counts/s, filtered, DATABASE_FIXED_SHIFT fractional bits
+static int32_t hookAcceleration = 0; // counts/s^2, filtered, DATABASE_FIXED_SHIFT fractional bits
+static uint32_t motionTimestamp = 0;
+static bool isSlow = false;
+static uint32_t slowSince = 0;
 static uint16_t hookPosition = INT16_MAX;
+static bool telemetryReceived = false; // Since the last database_resetTelemetry()
 static uint16_t voltage = 0;
 static int16_t current = 0;
 static Errors_e previousErrorNo = ERROR_NONE;
@@ -63,155 +76,461 @@ static uint8_t source = 0;
 static uint8_t id;
 static uint8_t data[4];
 
-static int16_t hommingSpeed = HOOK_HOMING_DIRECTION * 1500;
-static int16_t closingSpeed = HOOK_CLOSING_DIRECTION * 4000;
-static int16_t openingSpeed = HOOK_OPENING_DIRECTION * 2000;
+static int16_t hommingSpeed = DATABASE_DEFAULT_HOMING_SPEED;
+static int16_t closingSpeed = DATABASE_DEFAULT_CLOSING_SPEED;
+static int16_t openingSpeed = DATABASE_DEFAULT_OPENING_SPEED;
 
 static uint16_t currentLimitOperation = 10000;
 static uint16_t currentLimitRecovery = 5000;
 
 static uint16_t homingPosition = 0;
-static uint16_t closedPosition = 1;
-static uint16_t midPosition = 13720;
-static uint16_t openPosition = 18293;
+
+// Sorted by position, first entry is closed, last entry is open, HOOK_TARGET_MID is the middle entry
+static DatabaseWaypoint_t waypoints[DATABASE_MAX_WAYPOINTS] = {
+    {.name = "CLOSED", .position = 1, .tolerance = 0},
+    {.name = "MID", .position = DATABASE_DEFAULT_MID_POSITION, .tolerance = 0},
+    {.name = "OPEN", .position = DATABASE_DEFAULT_OPEN_POSITION, .tolerance = 0},
+};
+static uint32_t waypointCount = 3;
+
+/*
+ * Snapshot publication (seqcount latch)
+ *
+ * Two copies, the writer updates one while readers are pointed at the other by the low bit of
+ * snapshotSequence. A reader never waits for the writer, it only retries when an update completed
+ * while it was copying, so it also works from threads with a higher priority than the writer.
+ *
+ * Only the main thread (database_run) publishes, there is no protection between two writers. The
+ * copies are stored as words with relaxed atomic accesses, so a reader that overlaps a write gets
+ * a torn copy it then discards rather than a data race.
+ */
+#define SNAPSHOT_WORDS (sizeof(DatabaseSnapshot_t) / sizeof(uint32_t))
+_Static_assert(sizeof(DatabaseSnapshot_t) % sizeof(uint32_t) == 0, "Snapshot must be whole words");
+
+static uint32_t snapshots[2][SNAPSHOT_WORDS];
+static uint32_t snapshotSequence = 0;
+
+static HookDecoder_t decoder = {.state = HOOK_DECODER_SYNC};
+static uint32_t discardedBytes = 0;
+static uint32_t skippedSamples = 0;
 
 static uint32_t readyForLiftingTimer = 0;
 static uint32_t valueParameter = 0;
 static uint32_t isVelocityZero = 0;
 
-static int32_t calculateAbsVelocity(uint16_t);
-static bool isStopped(int32_t velocity);
+static void applyTelemetry(const HookReply_t *reply);
+static void applyEvents(const HookReply_t *reply);
+static void publishSnapshot(void);
+static int32_t waypointBelow(uint16_t position);
+static int32_t findWaypoint(uint16_t position, int32_t below);
+static void recordSample(const HookReply_t *reply);
+static void updateMotion(void);
 
 void database_run(void)
 {
-    uint32_t count = comm_getAvailableMotorDataLength();
-    HookReply_t reply;
+    Adt_CBufferSpan_t spans[2];
+    uint32_t discarded = 0;
+#if DATABASE_LATEST_TELEMETRY_ONLY
+    HookReply_t latest;
+    uint32_t frames = 0;
+#endif
+
+    // Bytes go to the decoder as they arrive, partial frames included, and are released right away
+    while (comm_peekMotorData(spans))
+    {
+        if (decoder.state == HOOK_DECODER_SYNC)
+        {
+            // Out of sync, drop everything up to the next candidate header in one go
+            discarded += comm_skipMotorDataUntil(HOOK_REPLY_HEADER);
+            if (!comm_peekMotorData(spans))
+                break;
+        }
 
-    while (count >= sizeof(HookReply_t))
+        uint32_t consumed;
+        HookDecoderResult_e result = hookDecoder_feed(&decoder, spans[0].data, spans[0].count, &consumed);
+        comm_releaseMotorData(consumed);
+
+        if (result == HOOK_DECODER_FRAME)
+        {
+            // Errors and parameter reads are events, none of them may be lost
+            applyEvents(&decoder.reply);
+#if DATABASE_LATEST_TELEMETRY_ONLY
+            latest = decoder.reply;
+            ++frames;
+#else
+            applyTelemetry(&decoder.reply);
+#endif
+        }
+        else if (result == HOOK_DECODER_CORRUPT)
+        {
+            LOG_INF("Invalid checksum %u != %u",
+                    (uint32_t)encoding_linkFinal(&decoder.ctx),
+                    (uint32_t)decoder.reply.checksum);
+            discarded += hookDecoder_resync(&decoder);
+        }
+    }
+
+#if DATABASE_LATEST_TELEMETRY_ONLY
+    // Position, voltage and current are samples, only the freshest one matters after a stall
+    if (frames)
     {
-        if (0xFE == comm_peekFromMotorBuffer())
+        applyTelemetry(&latest);
+        skippedSamples += frames - 1;
+    }
+#endif
+
+    if (historyCount != publishedCount)
+    {
+        publishedCount = historyCount;
+        publishSnapshot();
+    }
+
+    if (discarded)
+    {
+        discardedBytes += discarded;
+        LOG_INF("Discarded %d bytes (%d total)", discarded, discardedBytes);
+    }
+}
+
+void database_getSnapshot(DatabaseSnapshot_t *snapshot)
+{
+    uint32_t words[SNAPSHOT_WORDS];
+    uint32_t sequence;
+
+    do
+    {
+        sequence = __atomic_load_n(&snapshotSequence, __ATOMIC_ACQUIRE);
+        for (uint32_t i = 0; i < SNAPSHOT_WORDS; ++i)
         {
-            comm_removeFromMotorBuffer((uint8_t *)&reply, sizeof(HookReply_t));
-            count -= sizeof(HookReply_t);
+            words[i] = __atomic_load_n(&snapshots[sequence & 1][i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (sequence != __atomic_load_n(&snapshotSequence, __ATOMIC_RELAXED));
 
-            uint16_t fcs = encoding_calculateFletcher16Checksum((uint8_t *)&reply, sizeof(HookReply_t) - sizeof(uint16_t));
-            if (fcs == reply.checksum)
-            {
-                hookPosition = reply.data.position;
-                hookVelocity = calculateAbsVelocity(hookPosition);
-                isVelocityZero = isStopped(hookVelocity);
-                voltage = reply.data.voltage;
-                current = reply.data.current;
-                database_setError(reply.data.error);
-                sequenceNumber = reply.data.command.sequenceNumber;
-                source = reply.data.command.dataType;
-
-                switch (source)
-                {
-                case 1:
-                    id = reply.data.command.dataNumber;
-                    memcpy(data, reply.data.dataValues, sizeof(data));
-                    readyForLiftingTimer = *((uint32_t *)data);
-
-                    LOG_INF("Timer Value %d", readyForLiftingTimer);
-
-                case 0:
-                default:
-                    id = reply.data.command.dataNumber;
-                    memcpy(data, reply.data.dataValues, sizeof(data));
-                    valueParameter = *((uint32_t *)data);
-
-                    if (id)
-                    {
-                        LOG_INF("Read Parameter: %d = %d", id, valueParameter);
-                    }
-                    valueParameter = 0;
-                    id = 0;
-
-                    break;
-                }
-            }
-            else
-            {
-                LOG_INF("Invalid checksum %d != %d", fcs, reply.checksum);
-            }
+    memcpy(snapshot, words, sizeof(*snapshot));
+}
+
+static void publishSnapshot(void)
+{
+    DatabaseSnapshot_t update = {
+        .position = hookPosition,
+        .current = current,
+        .voltage = voltage,
+        .error = errorNo,
+        .stopped = isVelocityZero,
+    };
+
+    uint32_t sequence = __atomic_load_n(&snapshotSequence, __ATOMIC_RELAXED);
+    update.sequence = sequence / 2 + 1;
+
+    uint32_t words[SNAPSHOT_WORDS];
+    memcpy(words, &update, sizeof(words));
+
+    // Point readers at the odd copy while the even one is written, then back at the even one
+    for (uint32_t copy = 0; copy < 2; ++copy)
+    {
+        __atomic_store_n(&snapshotSequence, ++sequence, __ATOMIC_RELEASE);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (uint32_t i = 0; i < SNAPSHOT_WORDS; ++i)
+        {
+            __atomic_store_n(&snapshots[copy][i], words[i], __ATOMIC_RELAXED);
         }
-        else
+    }
+}
+
+uint32_t database_getDiscardedBytes(void)
+{
+    return discardedBytes;
+}
+
+uint32_t database_getSkippedSamples(void)
+{
+    return skippedSamples;
+}
+
+static void applyTelemetry(const HookReply_t *reply)
+{
+    // The controller falls back to an uninitialized position when it restarts, its parameters with it
+    if (reply->data.position == INT16_MAX && (hookPosition != INT16_MAX || !telemetryReceived))
+    {
+        mc_invalidateParameters();
+    }
+
+    hookPosition = reply->data.position;
+    voltage = reply->data.voltage;
+    current = reply->data.current;
+    telemetryReceived = true;
+
+    recordSample(reply);
+    updateMotion();
+}
+
+static void applyEvents(const HookReply_t *reply)
+{
+    database_setError(reply->data.error);
+    sequenceNumber = reply->data.command.sequenceNumber;
+    source = reply->data.command.dataType;
+
+    switch (source)
+    {
+    case 1:
+        id = reply->data.command.dataNumber;
+        memcpy(data, reply->data.dataValues, sizeof(data));
+        readyForLiftingTimer = *((uint32_t *)data);
+
+        LOG_INF("Timer Value %d", readyForLiftingTimer);
+
+    case 0:
+    default:
+        id = reply->data.command.dataNumber;
+        memcpy(data, reply->data.dataValues, sizeof(data));
+        valueParameter = *((uint32_t *)data);
+
+        if (id)
         {
-            uint8_t discard;
-            comm_removeFromMotorBuffer(&discard, 1);
-            --count;
-            LOG_INF("Discarded byte %x", discard);
+            LOG_INF("Read Parameter: %d = %d", id, valueParameter);
+            if (source == SOURCE_SPIN3204)
+            {
+                mc_updateParameter((Parameters_e)id, valueParameter);
+            }
         }
+        valueParameter = 0;
+        id = 0;
+
+        break;
     }
 }
 
 HookState_e database_getState(void)
 {
-    HookState_e result = HOOK_STATE_UNINITIALIZED;
+    HookState_e result = HOOK_STATE_ERROR;
+    int32_t last = waypointCount - 1;
 
-    if ((hookPosition <= closedPosition) || (hookPosition & 0x8000))
+    if (hookPosition & 0x8000)
     {
         result = HOOK_STATE_CLOSED;
     }
-    else if (hookPosition > closedPosition && hookPosition < midPosition)
+    else if (hookPosition == INT16_MAX)
     {
-        result = HOOK_STATE_PARTIALLY_CLOSED;
+        result = HOOK_STATE_UNINITIALIZED;
     }
-    else if (hookPosition == midPosition)
+    else
     {
-        result = HOOK_STATE_MID;
+        int32_t below = waypointBelow(hookPosition);
+        int32_t at = findWaypoint(hookPosition, below);
+
+        if (below < 0 || at == 0)
+        {
+            result = HOOK_STATE_CLOSED;
+        }
+        else if (at == last)
+        {
+            result = HOOK_STATE_OPEN;
+        }
+        else if (at > 0)
+        {
+            result = HOOK_STATE_MID;
+        }
+        else if (below < last)
+        {
+            // Between two waypoints, the lower half of the table is the closing side
+            result = (below + 1 <= (int32_t)waypointCount / 2) ? HOOK_STATE_PARTIALLY_CLOSED : HOOK_STATE_PARTIALLY_OPEN;
+        }
     }
-    else if (hookPosition > midPosition && hookPosition < openPosition)
+
+    return result;
+}
+
+/**
+ * Index of the last waypoint at or below position, -1 when position is below the first one
+ */
+static int32_t waypointBelow(uint16_t position)
+{
+    int32_t low = 0;
+    int32_t high = waypointCount - 1;
+    int32_t result = -1;
+
+    while (low <= high)
     {
-        result = HOOK_STATE_PARTIALLY_OPEN;
+        int32_t middle = (low + high) / 2;
+        if (waypoints[middle].position <= position)
+        {
+            result = middle;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
     }
-    else if (hookPosition == openPosition)
+
+    return result;
+}
+
+/**
+ * Index of the waypoint whose tolerance band holds position, -1 when there is none
+ *
+ * Bands do not overlap, so only the two neighbours of position can match.
+ */
+static int32_t findWaypoint(uint16_t position, int32_t below)
+{
+    if (below >= 0 && position - waypoints[below].position <= waypoints[below].tolerance)
+        return below;
+    if (below + 1 < (int32_t)waypointCount && waypoints[below + 1].position - position <= waypoints[below + 1].tolerance)
+        return below + 1;
+
+    return -1;
+}
+
+int32_t database_findWaypoint(uint16_t position)
+{
+    if (position & 0x8000)
+        return -1;
+
+    return findWaypoint(position, waypointBelow(position));
+}
+
+bool database_setWaypoints(const DatabaseWaypoint_t *table, uint32_t count)
+{
+    if (!table || count < DATABASE_MIN_WAYPOINTS || count > DATABASE_MAX_WAYPOINTS)
+        return true;
+
+    // Sorted, bands apart from each other and clear of the uninitialized marker
+    for (uint32_t i = 0; i < count; ++i)
     {
-        result = HOOK_STATE_OPEN;
+        uint32_t low = (table[i].position > table[i].tolerance) ? table[i].position - table[i].tolerance : 0;
+        uint32_t high = (uint32_t)table[i].position + table[i].tolerance;
+
+        if (high >= INT16_MAX)
+            return true;
+        if (i && (uint32_t)table[i - 1].position + table[i - 1].tolerance >= low)
+            return true;
     }
-    else if (hookPosition == INT16_MAX)
+
+    memcpy(waypoints, table, count * sizeof(DatabaseWaypoint_t));
+    for (uint32_t i = 0; i < count; ++i)
     {
-        result = HOOK_STATE_UNINITIALIZED;
+        waypoints[i].name[DATABASE_WAYPOINT_NAME_LENGTH - 1] = '\0';
     }
-    else
+    waypointCount = count;
+
+    return false;
+}
+
+uint32_t database_getWaypointCount(void)
+{
+    return waypointCount;
+}
+
+const DatabaseWaypoint_t *database_getWaypoint(uint32_t index)
+{
+    return (index < waypointCount) ? &waypoints[index] : NULL;
+}
+
+int32_t database_convertTargetToWaypoint(HookTarget_e target)
+{
+    int32_t result = -1;
+
+    switch (target)
     {
-        result = HOOK_STATE_ERROR;
+    case HOOK_TARGET_CLOSED:
+        result = 0;
+
+        break;
+    case HOOK_TARGET_MID:
+        result = waypointCount / 2;
+
+        break;
+    case HOOK_TARGET_OPEN:
+        result = waypointCount - 1;
+
+        break;
+    default:
+
+        break;
     }
 
     return result;
 }
 
-static int32_t calculateAbsVelocity(uint16_t hookCurrentPosition)
+static void recordSample(const HookReply_t *reply)
 {
-    int32_t velocity = ((int32_t)hookPreviousPosition - (int32_t)hookCurrentPosition);
-    hookPreviousPosition = hookCurrentPosition;
-    velocity = (velocity > 0) ? velocity : -velocity;
+    TelemetrySample_t *sample = &history[historyCount & (DATABASE_HISTORY_LENGTH - 1)];
 
-    return velocity;
+    sample->timestamp = k_uptime_get_32();
+    sample->position = reply->data.position;
+    sample->current = reply->data.current;
+    sample->voltage = reply->data.voltage;
+    ++historyCount;
 }
 
-static bool isStopped(int32_t velocity)
+/**
+ * Velocity, acceleration and stop detection from the newest sample
+ *
+ * Velocity is measured against the most recent sample at least DATABASE_VELOCITY_WINDOW_MS older
+ * (or the oldest one kept), using the real time between them, so the result does not depend on the
+ * telemetry rate. Stop detection uses that estimate directly, only the reported velocity and
+ * acceleration go through the IIR filter and would otherwise delay it.
+ */
+static void updateMotion(void)
 {
-    bool result = false;
+    uint32_t available = (historyCount < DATABASE_HISTORY_LENGTH) ? historyCount : DATABASE_HISTORY_LENGTH;
+    const TelemetrySample_t *newest = &history[(historyCount - 1) & (DATABASE_HISTORY_LENGTH - 1)];
+    const TelemetrySample_t *reference = NULL;
 
-    if (velocity < 25) // Testing value
+    for (uint32_t age = 1; age < available; ++age)
     {
-        ++hookVelocityCounter;
+        const TelemetrySample_t *sample = &history[(historyCount - 1 - age) & (DATABASE_HISTORY_LENGTH - 1)];
+        if (sample->timestamp == newest->timestamp)
+            continue;
+
+        reference = sample;
+        if (newest->timestamp - sample->timestamp >= DATABASE_VELOCITY_WINDOW_MS)
+            break;
     }
-    else
+
+    if (!reference)
+        return; // No time base yet
+
+    int32_t elapsed = newest->timestamp - reference->timestamp;
+    int32_t distance = (int32_t)(newest->position & HOOK_ENCODER_MASK) - (int32_t)(reference->position & HOOK_ENCODER_MASK);
+    int32_t velocity = (int32_t)(((int64_t)distance * 1000 * (1 << DATABASE_FIXED_SHIFT)) / elapsed);
+
+    int32_t previousVelocity = hookVelocity;
+    hookVelocity += (velocity - hookVelocity) / (1 << DATABASE_FILTER_SHIFT);
+
+    int32_t sinceUpdate = newest->timestamp - motionTimestamp;
+    if (motionTimestamp && sinceUpdate > 0)
     {
-        hookVelocityCounter = 0;
+        int32_t acceleration = (int32_t)(((int64_t)(hookVelocity - previousVelocity) * 1000) / sinceUpdate);
+        hookAcceleration += (acceleration - hookAcceleration) / (1 << DATABASE_FILTER_SHIFT);
     }
+    motionTimestamp = newest->timestamp;
 
-    if (hookVelocityCounter > 10) // 10 x 25ms = 250ms
+    if (abs(velocity) < (DATABASE_STOP_VELOCITY << DATABASE_FIXED_SHIFT))
     {
-        hookVelocityCounter = 10;
-        result = true;
+        if (!isSlow)
+        {
+            isSlow = true;
+            slowSince = newest->timestamp;
+        }
+    }
+    else
+    {
+        isSlow = false;
     }
 
+    isVelocityZero = isSlow && (newest->timestamp - slowSince >= DATABASE_STOP_HOLD_MS);
+}
 
-    return result;
+int32_t database_getVelocity(void)
+{
+    return hookVelocity / (1 << DATABASE_FIXED_SHIFT);
+}
+
+int32_t database_getAcceleration(void)
+{
+    return hookAcceleration / (1 << DATABASE_FIXED_SHIFT);
 }
 
 bool database_isStopped(void)
@@ -226,7 +545,7 @@ uint8_t database_isAtEndStroke(void)
 
 bool database_isPositionEncoderHome(void)
 {
-    return ((hookPosition <= closedPosition) || database_isAtEndStroke());
+    return ((hookPosition <= waypoints[0].position) || database_isAtEndStroke());
 }
 
 bool database_isProtectionTriggered(void)
@@ -243,9 +562,34 @@ bool database_isProtectionTriggered(void)
     return result;
 }
 
+void database_resetTelemetry(void)
+{
+    // Nothing is known about the hook until it reports on the new connection
+    hookPosition = INT16_MAX;
+    telemetryReceived = false;
+    hookDecoder_init(&decoder);
+
+    // Motion is estimated again from the first samples, not across the gap
+    historyCount = 0;
+    publishedCount = 0;
+    hookVelocity = 0;
+    hookAcceleration = 0;
+    motionTimestamp = 0;
+    isSlow = false;
+    slowSince = 0;
+    isVelocityZero = 0;
+    publishSnapshot();
+}
+
+bool database_hasTelemetry(void)
+{
+    return telemetryReceived;
+}
+
 void database_resetPosition(void)
 {
     hookPosition = 0;
+    publishSnapshot();
 }
 
 int16_t database_getHomingSpeed(void)
@@ -253,6 +597,15 @@ int16_t database_getHomingSpeed(void)
     return hommingSpeed;
 }
 
+void database_getDefaultCalibration(DatabaseCalibration_t *calibration)
+{
+    calibration->midPosition = DATABASE_DEFAULT_MID_POSITION;
+    calibration->openPosition = DATABASE_DEFAULT_OPEN_POSITION;
+    calibration->homingSpeed = DATABASE_DEFAULT_HOMING_SPEED;
+    calibration->closingSpeed = DATABASE_DEFAULT_CLOSING_SPEED;
+    calibration->openingSpeed = DATABASE_DEFAULT_OPENING_SPEED;
+}
+
 bool database_setHomingSpeed(int16_t speed)
 {
     hommingSpeed = speed;
@@ -314,15 +667,9 @@ uint16_t database_convertTargetToValue(HookTarget_e target)
 
         break;
     case HOOK_TARGET_CLOSED:
-        result = closedPosition;
-
-        break;
     case HOOK_TARGET_MID:
-        result = midPosition;
-
-        break;
     case HOOK_TARGET_OPEN:
-        result = openPosition;
+        result = waypoints[database_convertTargetToWaypoint(target)].position;
 
         break;
     }
@@ -330,6 +677,24 @@ uint16_t database_convertTargetToValue(HookTarget_e target)
     return result;
 }
 
+bool database_setTargetValue(HookTarget_e target, uint16_t value)
+{
+    // Homing and closed are defined by the end stroke, not calibrated
+    if (target != HOOK_TARGET_MID && target != HOOK_TARGET_OPEN)
+        return true;
+
+    DatabaseWaypoint_t table[DATABASE_MAX_WAYPOINTS];
+    memcpy(table, waypoints, waypointCount * sizeof(DatabaseWaypoint_t));
+    table[database_convertTargetToWaypoint(target)].position = value;
+
+    return database_setWaypoints(table, waypointCount);
+}
+
+uint16_t database_getPosition(void)
+{
+    return hookPosition;
+}
+
 int16_t database_getCurrent(void)
 {
     return current;
@@ -353,15 +718,20 @@ void database_setError(Errors_e error)
         LOG_INF("Error set to: %d", error);
     }
 
-    if (errorNo == ERROR_NONE)
+    if (errorNo == ERROR_NONE && error != ERROR_NONE)
     {
         errorNo = error;
+        publishSnapshot();
     }
 }
 
 void database_eackError(void)
 {
-    errorNo = ERROR_NONE;
+    if (errorNo != ERROR_NONE)
+    {
+        errorNo = ERROR_NONE;
+        publishSnapshot();
+    }
 }
 
 uint8_t database_getReplySeqNo(void)
@@ -1,5 +1,43 @@
-
 #include "encoding_checksum.h"
+#include <string.h>
+
+// Cortex-M4/M33 SIMD instructions (ACLE), define ENCODING_FLETCHER16_PORTABLE to force the C++ path.
+// The host tests define ENCODING_FLETCHER16_SIMD32 themselves to run it on emulated intrinsics.
+#if defined(__ARM_FEATURE_SIMD32) && !defined(ENCODING_FLETCHER16_PORTABLE) && !defined(ENCODING_FLETCHER16_SIMD32)
+#define ENCODING_FLETCHER16_SIMD32 1
+#endif
+#ifdef ENCODING_FLETCHER16_SIMD32
+#include <arm_acle.h>
+#endif
+
+namespace
+{
+
+// Adds 4 bytes to the running sums in one step, same result as 4 iterations of the byte loop:
+// c0 += b0 + b1 + b2 + b3
+// c1 += 4 * c0 + 4 * b0 + 3 * b1 + 2 * b2 + b3
+inline void fletcher16Accumulate4(const uint8_t *data, uint32_t &c0, uint32_t &c1)
+{
+#ifdef ENCODING_FLETCHER16_SIMD32
+    uint32_t word;
+    memcpy(&word, data, sizeof(word)); // b0 in the low byte (little endian)
+
+    // uxtb16 splits into halfword pairs {b0, b2} and {b1, b3}, smuad/smlad apply the weights
+    uint32_t weighted = __smlad(__uxtb16(word), 0x00020004, __smuad(__uxtb16(__ror(word, 8)), 0x00010003));
+    c1 += (c0 << 2) + weighted;
+    c0 = __usada8(word, 0, c0);
+#else
+    uint32_t b0 = data[0];
+    uint32_t b1 = data[1];
+    uint32_t b2 = data[2];
+    uint32_t b3 = data[3];
+
+    c1 += (c0 << 2) + (b0 << 2) + 3 * b1 + (b2 << 1) + b3;
+    c0 += b0 + b1 + b2 + b3;
+#endif
+}
+
+} // namespace
 
 uint16_t encoding_calculateFletcher16Checksum(const uint8_t *data, uint32_t bytes)
 {
@@ -10,7 +48,7 @@ uint16_t encoding_calculateFletcher16ChecksumWithSeed(const uint8_t *data,
                                                       uint32_t bytes,
                                                       uint16_t seed)
 {
-    // Optimized version, as found on wikipedia
+    // Optimized version, as found on wikipedia, unrolled to 4 bytes per iteration
     if (data == nullptr || bytes == 0)
         return 0;
 
@@ -25,11 +63,16 @@ uint16_t encoding_calculateFletcher16ChecksumWithSeed(const uint8_t *data,
     {
         uint32_t blocklen = bytes > max_blocklen ? max_blocklen : bytes;
         bytes -= blocklen;
-        do
+        for (; blocklen >= 4; blocklen -= 4)
+        {
+            fletcher16Accumulate4(data, c0, c1);
+            data += 4;
+        }
+        for (; blocklen; --blocklen)
         {
             c0 += *data++;
             c1 += c0;
-        } while (--blocklen);
+        }
         c0 %= 255;
         c1 %= 255;
     } while (bytes > 0);
@@ -48,3 +91,194 @@ bool encoding_isFletcher16ChecksumValid(const uint8_t *rxData, uint32_t bytes, u
 {
     return encoding_isFletcher16ChecksumValidWithSeed(rxData, bytes, rxChecksum, 0);
 }
+
+uint16_t encoding_fletcher16Combine(uint16_t checksumA, uint16_t checksumB, uint32_t lengthB)
+{
+    // Running B through the seeded loop adds A's c0 to every one of its lengthB prefix sums
+    uint32_t a0 = checksumA & 0xff;
+    uint32_t a1 = (checksumA & 0xff00) >> 8;
+    uint32_t b0 = checksumB & 0xff;
+    uint32_t b1 = (checksumB & 0xff00) >> 8;
+
+    uint32_t c0 = (a0 + b0) % 255;
+    uint32_t c1 = (a1 + (lengthB % 255) * a0 + b1) % 255;
+    return static_cast<uint16_t>(c1 << 8 | c0);
+}
+
+void encoding_fletcher16Init(Encoding_Fletcher16Ctx_t *ctx, uint16_t seed)
+{
+    ctx->checksum = seed;
+}
+
+void encoding_fletcher16Update(Encoding_Fletcher16Ctx_t *ctx, const uint8_t *data, uint32_t bytes)
+{
+    // The seeded calculation returns 0 for empty input, which would drop the running value
+    if (bytes == 0)
+        return;
+
+    ctx->checksum = encoding_calculateFletcher16ChecksumWithSeed(data, bytes, ctx->checksum);
+}
+
+uint16_t encoding_fletcher16Final(const Encoding_Fletcher16Ctx_t *ctx)
+{
+    return ctx->checksum;
+}
+
+namespace
+{
+
+// Slicing tables, table[k][i] is the CRC of byte i followed by k zero bytes.
+// Generated by the compiler and stored as constant data (flash).
+struct Crc16Tables
+{
+    uint16_t table[4][256];
+};
+
+struct Crc32Tables
+{
+    uint32_t table[8][256];
+};
+
+constexpr Crc16Tables makeCrc16Tables()
+{
+    Crc16Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+        tables.table[0][i] = crc;
+    }
+    for (uint32_t k = 1; k < 4; ++k)
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint16_t previous = tables.table[k - 1][i];
+            tables.table[k][i] = static_cast<uint16_t>((previous << 8) ^ tables.table[0][previous >> 8]);
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32Tables makeCrc32Tables()
+{
+    Crc32Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+        }
+        tables.table[0][i] = crc;
+    }
+    for (uint32_t k = 1; k < 8; ++k)
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t previous = tables.table[k - 1][i];
+            tables.table[k][i] = (previous >> 8) ^ tables.table[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc16Tables crc16Tables = makeCrc16Tables();
+constexpr Crc32Tables crc32Tables = makeCrc32Tables();
+
+static_assert(crc16Tables.table[0][1] == 0x1021, "CRC-16 table generation");
+static_assert(crc32Tables.table[0][1] == 0x77073096, "CRC-32 table generation");
+
+} // namespace
+
+uint16_t encoding_calculateCrc16Checksum(const uint8_t *data, uint32_t bytes)
+{
+    return encoding_calculateCrc16ChecksumWithSeed(data, bytes, ENCODING_CRC16_INIT);
+}
+
+uint16_t encoding_calculateCrc16ChecksumWithSeed(const uint8_t *data, uint32_t bytes, uint16_t seed)
+{
+    if (data == nullptr)
+        return seed;
+
+    const auto &t = crc16Tables.table;
+    uint32_t crc = seed;
+
+    // MSB first: the two CRC bytes line up with the first two data bytes
+    for (; bytes >= 4; bytes -= 4, data += 4)
+    {
+        crc = t[3][((crc >> 8) ^ data[0]) & 0xFF] ^ t[2][(crc ^ data[1]) & 0xFF] ^ t[1][data[2]] ^ t[0][data[3]];
+    }
+    for (; bytes; --bytes)
+    {
+        crc = ((crc << 8) ^ t[0][((crc >> 8) ^ *data++) & 0xFF]) & 0xFFFF;
+    }
+    return static_cast<uint16_t>(crc);
+}
+
+uint32_t encoding_calculateCrc32Checksum(const uint8_t *data, uint32_t bytes)
+{
+    return encoding_calculateCrc32ChecksumWithSeed(data, bytes, 0);
+}
+
+uint32_t encoding_calculateCrc32ChecksumWithSeed(const uint8_t *data, uint32_t bytes, uint32_t seed)
+{
+    if (data == nullptr)
+        return seed;
+
+    const auto &t = crc32Tables.table;
+    uint32_t crc = ~seed;
+
+    // Reflected: the four CRC bytes line up with the first four data bytes (little endian)
+    for (; bytes >= 8; bytes -= 8, data += 8)
+    {
+        uint32_t low = crc ^ (data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t>(data[3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; bytes; --bytes)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+void encoding_linkInit(Encoding_LinkCtx_t *ctx)
+{
+#if ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC16
+    ctx->checksum = ENCODING_CRC16_INIT;
+#else
+    ctx->checksum = 0;
+#endif
+}
+
+void encoding_linkUpdate(Encoding_LinkCtx_t *ctx, const uint8_t *data, uint32_t bytes)
+{
+    if (bytes == 0)
+        return;
+
+#if ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC32
+    ctx->checksum = encoding_calculateCrc32ChecksumWithSeed(data, bytes, ctx->checksum);
+#elif ENCODING_LINK_CHECKSUM == ENCODING_LINK_CRC16
+    ctx->checksum = encoding_calculateCrc16ChecksumWithSeed(data, bytes, ctx->checksum);
+#else
+    ctx->checksum = encoding_calculateFletcher16ChecksumWithSeed(data, bytes, ctx->checksum);
+#endif
+}
+
+Encoding_LinkChecksum_t encoding_linkFinal(const Encoding_LinkCtx_t *ctx)
+{
+    return ctx->checksum;
+}
+
+Encoding_LinkChecksum_t encoding_calculateLinkChecksum(const uint8_t *data, uint32_t bytes)
+{
+    Encoding_LinkCtx_t ctx;
+
+    encoding_linkInit(&ctx);
+    encoding_linkUpdate(&ctx, data, bytes);
+
+    return encoding_linkFinal(&ctx);
+}
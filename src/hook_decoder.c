@@ -0,0 +1,109 @@
+#include "hook_decoder.h"
+#include <stddef.h>
+#include <string.h>
+
+void hookDecoder_init(HookDecoder_t *decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->state = HOOK_DECODER_SYNC;
+}
+
+HookDecoderResult_e hookDecoder_feed(HookDecoder_t *decoder, const uint8_t *data, uint32_t length, uint32_t *consumed)
+{
+    uint8_t *frame = (uint8_t *)&decoder->reply;
+    HookDecoderResult_e result = HOOK_DECODER_NONE;
+    uint32_t i = 0;
+
+    while (i < length && result == HOOK_DECODER_NONE)
+    {
+        switch (decoder->state)
+        {
+        case HOOK_DECODER_SYNC:
+            if (data[i++] == HOOK_REPLY_HEADER)
+            {
+                frame[0] = HOOK_REPLY_HEADER;
+                decoder->index = 1;
+                decoder->checked = 0;
+                encoding_linkInit(&decoder->ctx);
+                decoder->state = HOOK_DECODER_HEADER;
+            }
+
+            break;
+        case HOOK_DECODER_HEADER:
+            frame[decoder->index++] = data[i++];
+            decoder->state = HOOK_DECODER_PAYLOAD;
+
+            break;
+        case HOOK_DECODER_PAYLOAD:
+        {
+            uint32_t run = offsetof(HookReply_t, checksum) - decoder->index;
+            run = (length - i < run) ? length - i : run;
+
+            memcpy(&frame[decoder->index], &data[i], run);
+            decoder->index += run;
+            i += run;
+
+            if (decoder->index == offsetof(HookReply_t, checksum))
+            {
+                decoder->state = HOOK_DECODER_CHECKSUM;
+            }
+
+            break;
+        }
+        case HOOK_DECODER_CHECKSUM:
+        {
+            // Everything before the trailer is in, bring the running checksum up to date
+            if (decoder->checked < offsetof(HookReply_t, checksum))
+            {
+                encoding_linkUpdate(&decoder->ctx, &frame[decoder->checked], offsetof(HookReply_t, checksum) - decoder->checked);
+                decoder->checked = offsetof(HookReply_t, checksum);
+            }
+
+            uint32_t run = sizeof(HookReply_t) - decoder->index;
+            run = (length - i < run) ? length - i : run;
+
+            memcpy(&frame[decoder->index], &data[i], run);
+            decoder->index += run;
+            i += run;
+
+            if (decoder->index == sizeof(HookReply_t))
+            {
+                bool valid = (encoding_linkFinal(&decoder->ctx) == decoder->reply.checksum);
+                result = valid ? HOOK_DECODER_FRAME : HOOK_DECODER_CORRUPT;
+                decoder->state = HOOK_DECODER_SYNC;
+            }
+
+            break;
+        }
+        }
+    }
+
+    // Partial frame, checksum what arrived so far while it is still hot
+    if (result == HOOK_DECODER_NONE && decoder->state != HOOK_DECODER_SYNC && decoder->checked < decoder->index &&
+        decoder->index <= offsetof(HookReply_t, checksum))
+    {
+        encoding_linkUpdate(&decoder->ctx, &frame[decoder->checked], decoder->index - decoder->checked);
+        decoder->checked = decoder->index;
+    }
+
+    *consumed = i;
+    return result;
+}
+
+uint32_t hookDecoder_resync(HookDecoder_t *decoder)
+{
+    const uint8_t *frame = (const uint8_t *)&decoder->reply;
+    const uint8_t *next = memchr(&frame[1], HOOK_REPLY_HEADER, sizeof(HookReply_t) - 1);
+    if (!next)
+        return sizeof(HookReply_t);
+
+    uint8_t replay[sizeof(HookReply_t)];
+    uint32_t length = &frame[sizeof(HookReply_t)] - next;
+    uint32_t consumed;
+    memcpy(replay, next, length);
+
+    // Shorter than a frame, so this can only leave the decoder part way into the next one
+    hookDecoder_feed(decoder, replay, length, &consumed);
+
+    return sizeof(HookReply_t) - length;
+}
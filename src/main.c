@@ -41,6 +41,8 @@
 #include <zephyr/logging/log.h>
 
 #include "system.h"
+#include "benchmark.h"
+#include "storage.h"
 
 #define LOG_MODULE_NAME central_uart
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -50,17 +52,39 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define PRIORITY_BLE 5
 #define PRIORITY_UI 7
 #define PRIORITY_RSSI 13
-#define UART_BUF_SIZE 20
+#define UART_BUF_SIZE 20   /* UART reception chunk, fits the default ATT MTU */
+#define BLE_TX_BUF_SIZE 64 /* Coalesced write, bounded by the negotiated MTU */
+#define UART_BUF_COUNT 16
 
 #define KEY_PASSKEY_ACCEPT DK_BTN1_MSK
 #define KEY_PASSKEY_REJECT DK_BTN2_MSK
 
 #define NUS_WRITE_TIMEOUT K_MSEC(150)
 #define UART_WAIT_FOR_BUF_DELAY K_MSEC(50)
+#define BLE_WAIT_FOR_BUF_TIMEOUT K_MSEC(100)
+#define BLE_TX_FLUSH_DELAY K_MSEC(5)
+#define BLE_ATT_DEFAULT_PAYLOAD (BT_ATT_DEFAULT_LE_MTU - 3)
+/* Blocks a single sendBLE() frame can span, at the smallest write size */
+#define BLE_TX_FRAME_BLOCKS DIV_ROUND_UP(UINT8_MAX, BLE_ATT_DEFAULT_PAYLOAD)
+
+/* Writes in flight when the peer accepts write without response, acknowledged
+ * writes are limited to one by the NUS client. */
+#ifndef BLE_TX_WINDOW
+#define BLE_TX_WINDOW 4
+#endif
 #define UART_RX_TIMEOUT 50
 
 #define CON_STATUS_LED 7
 
+/* Connection parameters in 1.25 ms interval and 10 ms timeout units. Short
+ * with no latency while the hook moves, relaxed while it hangs idle. */
+#define CONN_INTERVAL_ACTIVE_MIN 6  /* 7.5 ms */
+#define CONN_INTERVAL_ACTIVE_MAX 12 /* 15 ms */
+#define CONN_INTERVAL_IDLE_MIN 40   /* 50 ms */
+#define CONN_INTERVAL_IDLE_MAX 80   /* 100 ms */
+#define CONN_LATENCY_IDLE 2
+#define CONN_TIMEOUT 400 /* 4 s */
+
 static const struct device *uart = DEVICE_DT_GET(DT_NODELABEL(uart0));
 static struct k_work_delayable uart_work;
 
@@ -69,35 +93,130 @@ static const struct device *lcd = DEVICE_DT_GET(DT_NODELABEL(lcd_spi));
 static const struct gpio_dt_spec lcdcs = GPIO_DT_SPEC_GET(DT_NODELABEL(lcdcs),
 														  gpios);
 
-static K_SEM_DEFINE(nus_write_sem, 0, 1);
+static K_SEM_DEFINE(ble_tx_done_sem, 0, 1);
 static K_SEM_DEFINE(lcd_ini_ok, 0, 1);
 static K_SEM_DEFINE(rssi_sem, 0, 1);
 
 struct uart_data_t
 {
 	void *fifo_reserved;
-	uint8_t data[UART_BUF_SIZE];
+	uint8_t data[BLE_TX_BUF_SIZE];
 	uint16_t len;
 };
 
 static K_FIFO_DEFINE(fifo_uart_tx_data);
 static K_FIFO_DEFINE(fifo_uart_rx_data);
 
+/* Fixed size blocks for every UART and BLE transfer, constant time and no
+ * fragmentation of the heap. */
+K_MEM_SLAB_DEFINE_STATIC(uart_slab, sizeof(struct uart_data_t), UART_BUF_COUNT, 4);
+static atomic_t uart_buf_exhausted;
+static uint32_t uart_buf_peak;
+
+/* Does not count a failure as exhaustion, for callers that retry */
+static struct uart_data_t *buf_take(k_timeout_t timeout)
+{
+	struct uart_data_t *buf;
+
+	if (k_mem_slab_alloc(&uart_slab, (void **)&buf, timeout))
+	{
+		return NULL;
+	}
+
+	uint32_t used = k_mem_slab_num_used_get(&uart_slab);
+	if (used > uart_buf_peak)
+	{
+		uart_buf_peak = used;
+	}
+
+	buf->len = 0;
+	return buf;
+}
+
+static struct uart_data_t *buf_alloc(k_timeout_t timeout)
+{
+	struct uart_data_t *buf = buf_take(timeout);
+
+	if (!buf)
+	{
+		atomic_inc(&uart_buf_exhausted);
+	}
+
+	return buf;
+}
+
+static void buf_free(struct uart_data_t *buf)
+{
+	k_mem_slab_free(&uart_slab, buf);
+}
+
+/* Only changed on the BT thread. Other threads take their own reference
+ * through default_conn_get(), a disconnect cannot release it under them. */
 static struct bt_conn *default_conn;
+static struct k_spinlock default_conn_lock;
 static struct bt_nus_client nus_client;
+static bool nus_write_without_response;
+
+/* Handles of the bonded hook, reused while its GATT database hash matches */
+static StorageGattCache_t gatt_cache;
+static bool gatt_cache_verify;
+static struct bt_gatt_read_params db_hash_read;
+static const struct bt_uuid_16 db_hash_uuid = BT_UUID_INIT_16(BT_UUID_GATT_DB_HASH_VAL);
+static bool auto_connecting;
+static struct bt_gatt_subscribe_params nus_cached_subscribe;
+static uint16_t nus_rx_handle;
+static uint32_t link_lost_at;
+static atomic_t ble_tx_in_flight;
+
+/* Frames staged for the next write, sent when full or at the flush deadline.
+ * The payload size is set from BT callbacks, which never take the mutex. */
+static struct uart_data_t *ble_tx_staged;
+static atomic_t ble_tx_payload = ATOMIC_INIT(BLE_ATT_DEFAULT_PAYLOAD);
+static K_MUTEX_DEFINE(ble_tx_lock);
+
+static struct bt_conn *default_conn_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&default_conn_lock);
+	struct bt_conn *conn = default_conn ? bt_conn_ref(default_conn) : NULL;
+	k_spin_unlock(&default_conn_lock, key);
+
+	return conn;
+}
+
+/* Returns the previous connection, the caller owns its reference */
+static struct bt_conn *default_conn_swap(struct bt_conn *conn)
+{
+	k_spinlock_key_t key = k_spin_lock(&default_conn_lock);
+	struct bt_conn *previous = default_conn;
+	default_conn = conn;
+	k_spin_unlock(&default_conn_lock, key);
+
+	return previous;
+}
+
+static void ble_tx_complete(struct uart_data_t *buf)
+{
+	buf_free(buf);
+
+	/* The window is reset on disconnect, a write completing after that
+	 * does not take a credit of the next connection below zero */
+	atomic_val_t in_flight;
+	do
+	{
+		in_flight = atomic_get(&ble_tx_in_flight);
+	} while (in_flight > 0 &&
+			 !atomic_cas(&ble_tx_in_flight, in_flight, in_flight - 1));
+
+	k_sem_give(&ble_tx_done_sem);
+}
 
 static void ble_data_sent(struct bt_nus_client *nus, uint8_t err,
 						  const uint8_t *const data, uint16_t len)
 {
 	ARG_UNUSED(nus);
 
-	struct uart_data_t *buf;
-
 	/* Retrieve buffer context. */
-	buf = CONTAINER_OF(data, struct uart_data_t, data[0]);
-	k_free(buf);
-
-	k_sem_give(&nus_write_sem);
+	ble_tx_complete(CONTAINER_OF(data, struct uart_data_t, data[0]));
 
 	if (err)
 	{
@@ -105,6 +224,13 @@ static void ble_data_sent(struct bt_nus_client *nus, uint8_t err,
 	}
 }
 
+static void ble_data_sent_without_response(struct bt_conn *conn, void *user_data)
+{
+	ARG_UNUSED(conn);
+
+	ble_tx_complete(user_data);
+}
+
 static uint8_t ble_data_received(struct bt_nus_client *nus,
 								 const uint8_t *data, uint16_t len)
 {
@@ -156,7 +282,7 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
 							   data[0]);
 		}
 
-		k_free(buf);
+		buf_free(buf);
 
 		buf = k_fifo_get(&fifo_uart_tx_data, K_NO_WAIT);
 		if (!buf)
@@ -194,34 +320,32 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
 		LOG_DBG("UART_RX_DISABLED");
 		disable_req = false;
 
-		buf = k_malloc(sizeof(*buf));
-		if (buf)
-		{
-			buf->len = 0;
-		}
-		else
+		buf = buf_alloc(K_NO_WAIT);
+		if (!buf)
 		{
-			LOG_WRN("Not able to allocate UART receive buffer");
+			/* Reception resumes once the BLE side has returned blocks */
+			LOG_WRN("UART receive buffers exhausted");
 			k_work_reschedule(&uart_work, UART_WAIT_FOR_BUF_DELAY);
 			return;
 		}
 
-		uart_rx_enable(uart, buf->data, sizeof(buf->data),
+		uart_rx_enable(uart, buf->data, UART_BUF_SIZE,
 					   UART_RX_TIMEOUT);
 
 		break;
 
 	case UART_RX_BUF_REQUEST:
 		LOG_DBG("UART_RX_BUF_REQUEST");
-		buf = k_malloc(sizeof(*buf));
+		buf = buf_alloc(K_NO_WAIT);
 		if (buf)
 		{
-			buf->len = 0;
-			uart_rx_buf_rsp(uart, buf->data, sizeof(buf->data));
+			uart_rx_buf_rsp(uart, buf->data, UART_BUF_SIZE);
 		}
 		else
 		{
-			LOG_WRN("Not able to allocate UART receive buffer");
+			/* Without a next buffer the driver disables reception,
+			 * UART_RX_DISABLED then retries from the work queue */
+			LOG_WRN("UART receive buffers exhausted");
 		}
 
 		break;
@@ -237,7 +361,7 @@ static void uart_cb(const struct device *dev, struct uart_event *evt, void *user
 		}
 		else
 		{
-			k_free(buf);
+			buf_free(buf);
 		}
 
 		break;
@@ -267,19 +391,14 @@ static void uart_work_handler(struct k_work *item)
 {
 	struct uart_data_t *buf;
 
-	buf = k_malloc(sizeof(*buf));
-	if (buf)
-	{
-		buf->len = 0;
-	}
-	else
+	buf = buf_alloc(K_NO_WAIT);
+	if (!buf)
 	{
-		LOG_WRN("Not able to allocate UART receive buffer");
 		k_work_reschedule(&uart_work, UART_WAIT_FOR_BUF_DELAY);
 		return;
 	}
 
-	uart_rx_enable(uart, buf->data, sizeof(buf->data), UART_RX_TIMEOUT);
+	uart_rx_enable(uart, buf->data, UART_BUF_SIZE, UART_RX_TIMEOUT);
 }
 
 static int uart_init(void)
@@ -293,12 +412,8 @@ static int uart_init(void)
 		return -ENODEV;
 	}
 
-	rx = k_malloc(sizeof(*rx));
-	if (rx)
-	{
-		rx->len = 0;
-	}
-	else
+	rx = buf_alloc(K_NO_WAIT);
+	if (!rx)
 	{
 		return -ENOMEM;
 	}
@@ -311,10 +426,12 @@ static int uart_init(void)
 		return err;
 	}
 
-	return uart_rx_enable(uart, rx->data, sizeof(rx->data),
+	return uart_rx_enable(uart, rx->data, UART_BUF_SIZE,
 						  UART_RX_TIMEOUT);
 }
 
+static int read_db_hash(struct bt_conn *conn, bool verify);
+
 static void discovery_complete(struct bt_gatt_dm *dm,
 							   void *context)
 {
@@ -325,8 +442,28 @@ static void discovery_complete(struct bt_gatt_dm *dm,
 
 	bt_nus_handles_assign(dm, nus);
 	bt_nus_subscribe_receive(nus);
+	nus_rx_handle = nus->handles.rx;
+	LOG_INF("NUS ready %u ms after link loss, discovery ran",
+			k_uptime_get_32() - link_lost_at);
+
+	/* Pipelined writes need the peer to accept write without response */
+	const struct bt_gatt_dm_attr *rx = bt_gatt_dm_char_by_uuid(dm, BT_UUID_NUS_RX);
+	const struct bt_gatt_chrc *chrc = rx ? bt_gatt_dm_attr_chrc_val(rx) : NULL;
+
+	nus_write_without_response = chrc &&
+								 (chrc->properties & BT_GATT_CHRC_WRITE_WITHOUT_RESP);
+	LOG_INF("NUS writes %s", nus_write_without_response ? "pipelined" : "acknowledged");
+
+	/* Cached together with the database hash, read next */
+	memcpy(gatt_cache.peer, bt_conn_get_dst(nus->conn), sizeof(gatt_cache.peer));
+	gatt_cache.rx = nus->handles.rx;
+	gatt_cache.tx = nus->handles.tx;
+	gatt_cache.txCcc = nus->handles.tx_ccc;
+	gatt_cache.rxProperties = chrc ? chrc->properties : 0;
 
 	bt_gatt_dm_data_release(dm);
+
+	read_db_hash(nus->conn, false);
 }
 
 static void discovery_service_not_found(struct bt_conn *conn,
@@ -348,15 +485,10 @@ struct bt_gatt_dm_cb discovery_cb = {
 	.error_found = discovery_error,
 };
 
-static void gatt_discover(struct bt_conn *conn)
+static void discovery_start(struct bt_conn *conn)
 {
 	int err;
 
-	if (conn != default_conn)
-	{
-		return;
-	}
-
 	err = bt_gatt_dm_start(conn,
 						   BT_UUID_NUS_SERVICE,
 						   &discovery_cb,
@@ -369,11 +501,146 @@ static void gatt_discover(struct bt_conn *conn)
 	}
 }
 
+static uint8_t nus_cached_notify(struct bt_conn *conn,
+								 struct bt_gatt_subscribe_params *params,
+								 const void *data, uint16_t length)
+{
+	if (!data)
+	{
+		/* Unsubscribed, the link is gone */
+		params->value_handle = 0;
+		return BT_GATT_ITER_STOP;
+	}
+
+	return ble_data_received(NULL, data, length);
+}
+
+/* The NUS client only takes its handles from a discovery, with cached handles
+ * the TX characteristic is subscribed and the RX one written through plain
+ * GATT calls instead. */
+static int nus_assign_cached(struct bt_conn *conn)
+{
+	/* Acknowledged writes go through the NUS client, pipelined ones do not */
+	if (!(gatt_cache.rxProperties & BT_GATT_CHRC_WRITE_WITHOUT_RESP))
+	{
+		return -ENOTSUP;
+	}
+
+	nus_cached_subscribe.notify = nus_cached_notify;
+	nus_cached_subscribe.value = BT_GATT_CCC_NOTIFY;
+	nus_cached_subscribe.value_handle = gatt_cache.tx;
+	nus_cached_subscribe.ccc_handle = gatt_cache.txCcc;
+	/* Removed on disconnect, subscribed again on the next connection */
+	atomic_set_bit(nus_cached_subscribe.flags, BT_GATT_SUBSCRIBE_FLAG_VOLATILE);
+
+	int err = bt_gatt_subscribe(conn, &nus_cached_subscribe);
+	if (err)
+	{
+		return err;
+	}
+
+	nus_rx_handle = gatt_cache.rx;
+	nus_write_without_response = true;
+	LOG_INF("NUS ready %u ms after link loss, discovery skipped",
+			k_uptime_get_32() - link_lost_at);
+
+	return 0;
+}
+
+static uint8_t db_hash_read_cb(struct bt_conn *conn, uint8_t err,
+							   struct bt_gatt_read_params *params,
+							   const void *data, uint16_t length)
+{
+	bool valid = !err && data && (length == STORAGE_GATT_HASH_SIZE);
+
+	if (!gatt_cache_verify)
+	{
+		/* After a discovery, keep the handles for the next connection */
+		if (valid)
+		{
+			memcpy(gatt_cache.hash, data, STORAGE_GATT_HASH_SIZE);
+			storage_saveGattCache(&gatt_cache);
+		}
+	}
+	else if (!valid || memcmp(gatt_cache.hash, data, STORAGE_GATT_HASH_SIZE) ||
+			 nus_assign_cached(conn))
+	{
+		LOG_INF("GATT cache not usable (err %u), discovering", err);
+		discovery_start(conn);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+static int read_db_hash(struct bt_conn *conn, bool verify)
+{
+	gatt_cache_verify = verify;
+
+	db_hash_read.func = db_hash_read_cb;
+	db_hash_read.handle_count = 0;
+	db_hash_read.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	db_hash_read.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	db_hash_read.by_uuid.uuid = &db_hash_uuid.uuid;
+
+	return bt_gatt_read(conn, &db_hash_read);
+}
+
+static void gatt_discover(struct bt_conn *conn)
+{
+	if (conn != default_conn)
+	{
+		return;
+	}
+
+	/* A bonded hook with an unchanged database keeps its handles, one
+	 * read instead of a full discovery */
+	if (storage_getGattCache(&gatt_cache) &&
+		!memcmp(gatt_cache.peer, bt_conn_get_dst(conn), sizeof(gatt_cache.peer)) &&
+		!read_db_hash(conn, true))
+	{
+		return;
+	}
+
+	discovery_start(conn);
+}
+
+/* The known hook goes on the accept list and is connected by the controller
+ * on its first advertisement, a UUID scan finds any other hook. */
+static int connect_start(void)
+{
+	int err;
+	StorageGattCache_t cache;
+
+	if (!auto_connecting && storage_getGattCache(&cache))
+	{
+		bt_le_filter_accept_list_clear();
+		err = bt_le_filter_accept_list_add((const bt_addr_le_t *)cache.peer);
+		if (!err)
+		{
+			err = bt_conn_le_create_auto(
+				BT_CONN_LE_CREATE_PARAM(BT_CONN_LE_OPT_CODED | BT_CONN_LE_OPT_NO_1M,
+										BT_GAP_SCAN_FAST_INTERVAL,
+										BT_GAP_SCAN_FAST_INTERVAL),
+				BT_LE_CONN_PARAM_DEFAULT);
+		}
+		if (!err)
+		{
+			auto_connecting = true;
+			return 0;
+		}
+		LOG_WRN("Connecting to the known hook failed (err %d)", err);
+	}
+
+	auto_connecting = false;
+	return bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
+}
+
 static void exchange_func(struct bt_conn *conn, uint8_t err, struct bt_gatt_exchange_params *params)
 {
 	if (!err)
 	{
-		LOG_INF("MTU exchange done");
+		atomic_set(&ble_tx_payload, bt_gatt_get_mtu(conn) - 3);
+		LOG_INF("MTU exchange done, %ld byte writes", atomic_get(&ble_tx_payload));
 	}
 	else
 	{
@@ -394,8 +661,7 @@ static void connected(struct bt_conn *conn, uint8_t conn_err)
 
 		if (default_conn == conn)
 		{
-			bt_conn_unref(default_conn);
-			default_conn = NULL;
+			bt_conn_unref(default_conn_swap(NULL));
 
 			err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
 			if (err)
@@ -404,12 +670,30 @@ static void connected(struct bt_conn *conn, uint8_t conn_err)
 						err);
 			}
 		}
+		else if (auto_connecting)
+		{
+			/* Known hook not seen within the create timeout, fall
+			 * back to scanning for any hook */
+			err = connect_start();
+			if (err)
+			{
+				LOG_ERR("Scanning failed to start (err %d)",
+						err);
+			}
+		}
 
 		return;
 	}
 
+	if (auto_connecting)
+	{
+		auto_connecting = false;
+		default_conn_swap(bt_conn_ref(conn));
+	}
+
 	dk_set_led_on(CON_STATUS_LED);
 	LOG_INF("Connected: %s", addr);
+	system_setPeer((const uint8_t *)bt_conn_get_dst(conn), sizeof(bt_addr_le_t));
 
 	static struct bt_gatt_exchange_params exchange_params;
 
@@ -452,13 +736,23 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 		return;
 	}
 
-	bt_conn_unref(default_conn);
-	default_conn = NULL;
+	/* Cleared before the connection goes, the TX thread must not pick a
+	 * write path for a link that is already gone */
+	nus_write_without_response = false;
+	bt_conn_unref(default_conn_swap(NULL));
+	link_lost_at = k_uptime_get_32();
+
+	/* Writes lost with the link never complete, the next connection
+	 * starts with the whole window */
+	atomic_set(&ble_tx_in_flight, 0);
+	k_sem_give(&ble_tx_done_sem);
 
-	err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
+	atomic_set(&ble_tx_payload, BLE_ATT_DEFAULT_PAYLOAD);
+
+	err = connect_start();
 	if (err)
 	{
-		LOG_ERR("Scanning failed to start (err %d)",
+		LOG_ERR("Connecting failed to start (err %d)",
 				err);
 	}
 }
@@ -478,15 +772,55 @@ static void security_changed(struct bt_conn *conn, bt_security_t level,
 	{
 		LOG_WRN("Security failed: %s level %u err %d", addr,
 				level, err);
+
+		/* The hook dropped its keys, its cached handles go with the bond */
+		if (err == BT_SECURITY_ERR_PIN_OR_KEY_MISSING)
+		{
+			storage_clearGattCache((const uint8_t *)bt_conn_get_dst(conn),
+								   sizeof(bt_addr_le_t));
+		}
 	}
 
 	gatt_discover(conn);
 }
 
+static void le_param_updated(struct bt_conn *conn, uint16_t interval,
+							 uint16_t latency, uint16_t timeout)
+{
+	LOG_INF("Connection interval %u us, latency %u, timeout %u ms",
+			interval * 1250, latency, timeout * 10);
+}
+
 BT_CONN_CB_DEFINE(conn_callbacks) = {
 	.connected = connected,
 	.disconnected = disconnected,
-	.security_changed = security_changed};
+	.security_changed = security_changed,
+	.le_param_updated = le_param_updated};
+
+void setLinkActive(bool active)
+{
+	int err;
+	struct bt_le_conn_param param = {
+		.interval_min = active ? CONN_INTERVAL_ACTIVE_MIN : CONN_INTERVAL_IDLE_MIN,
+		.interval_max = active ? CONN_INTERVAL_ACTIVE_MAX : CONN_INTERVAL_IDLE_MAX,
+		.latency = active ? 0 : CONN_LATENCY_IDLE,
+		.timeout = CONN_TIMEOUT,
+	};
+
+	/* Called from the main thread, a disconnect can release default_conn meanwhile */
+	struct bt_conn *conn = default_conn_get();
+	if (!conn)
+	{
+		return;
+	}
+
+	err = bt_conn_le_param_update(conn, &param);
+	bt_conn_unref(conn);
+	if (err && (err != -EALREADY))
+	{
+		LOG_WRN("Connection parameter update failed (err %d)", err);
+	}
+}
 
 static void scan_filter_match(struct bt_scan_device_info *device_info,
 							  struct bt_scan_filter_match *filter_match,
@@ -495,6 +829,7 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 	int err;
 	char addr[BT_ADDR_LE_STR_LEN];
 	struct bt_conn_le_create_param *conn_params;
+	struct bt_conn *conn = NULL;
 
 	bt_addr_le_to_str(device_info->recv_info->addr, addr, sizeof(addr));
 
@@ -512,8 +847,12 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 		BT_GAP_SCAN_FAST_INTERVAL);
 	err = bt_conn_le_create(device_info->recv_info->addr, conn_params,
 							BT_LE_CONN_PARAM_DEFAULT,
-							&default_conn);
-	if (err)
+							&conn);
+	if (!err)
+	{
+		default_conn_swap(conn);
+	}
+	else
 	{
 		LOG_INF("Create conn failed (err %d)", err);
 		err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
@@ -534,7 +873,7 @@ static void scan_connecting_error(struct bt_scan_device_info *device_info)
 static void scan_connecting(struct bt_scan_device_info *device_info,
 							struct bt_conn *conn)
 {
-	default_conn = bt_conn_ref(conn);
+	default_conn_swap(bt_conn_ref(conn));
 }
 
 static int nus_client_init(void)
@@ -628,9 +967,20 @@ static struct bt_conn_auth_cb conn_auth_callbacks = {
 	.cancel = auth_cancel,
 };
 
+static void bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	bt_addr_le_to_str(peer, addr, sizeof(addr));
+
+	LOG_INF("Bond deleted: %s", addr);
+	storage_clearGattCache((const uint8_t *)peer, sizeof(*peer));
+}
+
 static struct bt_conn_auth_info_cb conn_auth_info_callbacks = {
 	.pairing_complete = pairing_complete,
-	.pairing_failed = pairing_failed};
+	.pairing_failed = pairing_failed,
+	.bond_deleted = bond_deleted};
 
 static void configure_gpio(void)
 {
@@ -735,14 +1085,19 @@ int main(void)
 	printk("**STAVENG TRANSFERA** \n");
 	printk("-- Searching for slaves... \n");
 
-	err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
+#ifdef BENCHMARK_ENABLE
+	benchmark_run();
+#endif
+
+	link_lost_at = k_uptime_get_32();
+	err = connect_start();
 	if (err)
 	{
-		LOG_ERR("Scanning failed to start (err %d)", err);
+		LOG_ERR("Connecting failed to start (err %d)", err);
 		return 0;
 	}
 
-	LOG_INF("Scanning successfully started");
+	LOG_INF("Connecting successfully started");
 
 	system_init(lcd, &lcdcs);
 	k_sem_give(&lcd_ini_ok);
@@ -750,39 +1105,139 @@ int main(void)
 	for (;;)
 	{
 		system_thread();
-		k_sleep(K_MSEC(25));
 	}
 }
 
-void sendBLE(uint8_t *data, uint8_t len)
+static void ble_tx_flush_locked(void)
 {
-	for (uint16_t pos = 0; pos != len;)
+	if (ble_tx_staged)
 	{
-		struct uart_data_t *tx = k_malloc(sizeof(*tx));
+		k_fifo_put(&fifo_uart_rx_data, ble_tx_staged);
+		ble_tx_staged = NULL;
+	}
+}
+
+static void ble_tx_flush_handler(struct k_work *work)
+{
+	k_mutex_lock(&ble_tx_lock, K_FOREVER);
+	ble_tx_flush_locked();
+	k_mutex_unlock(&ble_tx_lock);
+}
+
+static K_WORK_DELAYABLE_DEFINE(ble_tx_flush_work, ble_tx_flush_handler);
+
+void flushBLE(void)
+{
+	k_work_cancel_delayable(&ble_tx_flush_work);
+	ble_tx_flush_handler(NULL);
+}
+
+static void ble_tx_send(const uint8_t *data, uint8_t len, k_timeout_t timeout)
+{
+	struct uart_data_t *blocks[BLE_TX_FRAME_BLOCKS];
+	struct uart_data_t *spare = NULL;
+	uint16_t reserved;
+	uint16_t used = 0;
+	uint16_t limit;
+	bool fits;
+
+	for (;;)
+	{
+		k_mutex_lock(&ble_tx_lock, K_FOREVER);
+
+		limit = MIN((uint16_t)atomic_get(&ble_tx_payload), BLE_TX_BUF_SIZE);
 
-		if (!tx)
+		/* A frame that does not fit behind the staged ones starts the next
+		 * write, only frames larger than a whole write are split. Blocks for
+		 * all of it are reserved before anything is copied, a short pool drops
+		 * the frame as a unit instead of sending a partial one. */
+		fits = ble_tx_staged && (ble_tx_staged->len + len) <= limit;
+		uint16_t needed = fits ? 0 : DIV_ROUND_UP(len, limit);
+
+		for (reserved = 0; reserved < needed; reserved++)
+		{
+			blocks[reserved] = spare ? spare : buf_take(K_NO_WAIT);
+			spare = NULL;
+			if (!blocks[reserved])
+			{
+				break;
+			}
+		}
+
+		if (reserved == needed)
 		{
-			LOG_WRN("Not able to allocate UART send data buffer");
+			break;
+		}
+
+		k_mutex_unlock(&ble_tx_lock);
+		while (reserved)
+		{
+			buf_free(blocks[--reserved]);
+		}
+
+		/* A full pool means the link is behind, waits once for the BLE thread
+		 * to return a block. Outside the mutex so the flush work and other
+		 * senders are never held up by the wait. */
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) || !(spare = buf_take(timeout)))
+		{
+			atomic_inc(&uart_buf_exhausted);
+			LOG_WRN("BLE send buffers exhausted, %u byte frame dropped (%ld times, peak %u)",
+					len, atomic_get(&uart_buf_exhausted), uart_buf_peak);
 			return;
 		}
+		timeout = K_NO_WAIT;
+	}
+
+	if (!fits)
+	{
+		ble_tx_flush_locked();
+	}
 
-		if ((len - pos) > sizeof(tx->data))
+	for (uint16_t pos = 0; pos != len;)
+	{
+		if (!ble_tx_staged)
 		{
-			tx->len = sizeof(tx->data);
+			ble_tx_staged = blocks[used++];
 		}
-		else
+
+		uint16_t chunk = MIN(len - pos, limit - ble_tx_staged->len);
+
+		memcpy(&ble_tx_staged->data[ble_tx_staged->len], &data[pos], chunk);
+		ble_tx_staged->len += chunk;
+		pos += chunk;
+
+		if (ble_tx_staged->len == limit)
 		{
-			tx->len = (len - pos);
+			ble_tx_flush_locked();
 		}
+	}
 
-		memcpy(tx->data, &data[pos], tx->len);
+	/* Deadline counts from the first staged frame, later ones do not push it out */
+	if (ble_tx_staged)
+	{
+		k_work_schedule(&ble_tx_flush_work, BLE_TX_FLUSH_DELAY);
+	}
 
-		pos += tx->len;
+	k_mutex_unlock(&ble_tx_lock);
 
-		k_fifo_put(&fifo_uart_rx_data, tx);
+	/* Left over when the frame fit behind the staged ones after the wait */
+	if (spare)
+	{
+		buf_free(spare);
 	}
 }
 
+void sendBLE(const uint8_t *data, uint8_t len)
+{
+	ble_tx_send(data, len, BLE_WAIT_FOR_BUF_TIMEOUT);
+}
+
+/* Never waits for a block, for callers that must not stall the main loop */
+void sendBLENoWait(const uint8_t *data, uint8_t len)
+{
+	ble_tx_send(data, len, K_NO_WAIT);
+}
+
 static void update_user_interface(void)
 {
 	k_sem_take(&lcd_ini_ok, K_FOREVER);
@@ -790,9 +1245,14 @@ static void update_user_interface(void)
 	for (;;)
 	{
 		struct bt_conn_info info = {.state = BT_CONN_STATE_DISCONNECTED};
-		if (default_conn && bt_conn_get_info(default_conn, &info))
+		struct bt_conn *conn = default_conn_get();
+		if (conn)
 		{
-			LOG_WRN("Error getting BT connection info");
+			if (bt_conn_get_info(conn, &info))
+			{
+				LOG_WRN("Error getting BT connection info");
+			}
+			bt_conn_unref(conn);
 		}
 
 		uint8_t connectionState = 0;
@@ -805,6 +1265,31 @@ static void update_user_interface(void)
 	}
 }
 
+static int ble_send(struct uart_data_t *buf)
+{
+	int err;
+	struct bt_conn *conn = default_conn_get();
+
+	if (!conn)
+	{
+		return -ENOTCONN;
+	}
+
+	if (nus_write_without_response)
+	{
+		err = bt_gatt_write_without_response_cb(conn, nus_rx_handle,
+												buf->data, buf->len, false,
+												ble_data_sent_without_response, buf);
+	}
+	else
+	{
+		err = bt_nus_client_send(&nus_client, buf->data, buf->len);
+	}
+
+	bt_conn_unref(conn);
+	return err;
+}
+
 static void ble_write_thread(void)
 {
 	for (;;)
@@ -814,19 +1299,25 @@ static void ble_write_thread(void)
 		struct uart_data_t *buf = k_fifo_get(&fifo_uart_rx_data,
 											 K_FOREVER);
 
-		if (bt_nus_client_send(&nus_client, buf->data, buf->len))
+		/* Keep up to the window in flight, completions free a slot */
+		while (atomic_get(&ble_tx_in_flight) >=
+			   (nus_write_without_response ? BLE_TX_WINDOW : 1))
 		{
-			LOG_WRN("Failed to send data over BLE connection");
-		}
-
-		while (k_sem_take(&nus_write_sem, NUS_WRITE_TIMEOUT))
-		{
-			if (log)
+			if (k_sem_take(&ble_tx_done_sem, NUS_WRITE_TIMEOUT) && log)
 			{
 				LOG_WRN("NUS send timeout");
 				log = 0;
 			}
 		}
+
+		atomic_inc(&ble_tx_in_flight);
+		if (ble_send(buf))
+		{
+			/* No sent callback follows, return the block here */
+			LOG_WRN("Failed to send data over BLE connection");
+			atomic_dec(&ble_tx_in_flight);
+			buf_free(buf);
+		}
 	}
 }
 
@@ -838,7 +1329,13 @@ void ble_rssi_thread(void)
 	{
 		k_sem_take(&rssi_sem, K_FOREVER);
 		k_sleep(K_MSEC(2000));
-		bt_hci_get_conn_handle(default_conn, &conn_handle);
+		struct bt_conn *conn = default_conn_get();
+		if (!conn)
+		{
+			continue;
+		}
+		bt_hci_get_conn_handle(conn, &conn_handle);
+		bt_conn_unref(conn);
 		sdc_hci_cmd_sp_read_rssi_t p_param = {conn_handle};
 
 		for (;;)
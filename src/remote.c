@@ -2,6 +2,7 @@
 #include "lcd_spiModule.h"
 #include "dk_buttons_and_leds.h"
 #include "commands.h"
+#include "storage.h"
 
 #include <zephyr/logging/log.h>
 
@@ -43,9 +44,11 @@ static uint32_t midButton = 0;
 static uint32_t openButton = 0;
 static uint32_t parameterButton = 0;
 static int32_t rssiValue = 0;
+static bool warmStartChecked = false;
 
 static void updateButtons(void);
 static void stateMachine(void);
+static int32_t nextIntermediateWaypoint(void);
 
 void remote_init(void)
 {
@@ -58,6 +61,11 @@ void remote_updateButtons(uint32_t button_state, uint32_t has_changed)
 
     if (button_state & BUTTON_ESTOP_MASK)
     {
+        if (has_changed & BUTTON_ESTOP_MASK)
+        {
+            // Does not wait for the state machine, the stop preempts whatever command runs
+            command_requestStop();
+        }
         buttonsExecute |= BUTTON_ESTOP_MASK;
         LOG_INF("Execute button %d", buttonsExecute);
     }
@@ -122,10 +130,15 @@ void remote_setRssi(int8_t rssi)
     rssiValue = rssi;
 }
 
-void remote_disconnectedUi(void)
+void remote_disconnected(void)
 {
+    // Main thread, together with the rest of the state machine
     hookState = HOOK_STATE_UNINITIALIZED;
-    command_flush();
+    warmStartChecked = false;
+}
+
+void remote_disconnectedUi(void)
+{
     lcd_set_cursor(1, 1);
     lcd_send_string(">Disconnected!");
     lcd_clear_eol();
@@ -146,8 +159,12 @@ void remote_disconnectedUi(void)
 
 void remote_updateUi(void)
 {
-    float voltage = ((float)database_getVoltage() / 1000.0f);
-    //    float current = ((float)database_getCurrent() / 1000.0f);
+    // Runs in the UI thread, take everything the main thread updates from one consistent snapshot
+    DatabaseSnapshot_t snapshot;
+    database_getSnapshot(&snapshot);
+
+    float voltage = ((float)snapshot.voltage / 1000.0f);
+    //    float current = ((float)snapshot.current / 1000.0f);
 
     lcd_set_cursor(1, 1);
     lcd_print(">RSSI(dBm):%.0f", rssiValue);
@@ -185,6 +202,13 @@ void remote_updateUi(void)
         dk_set_led_on(MID_LED);
         positionString = stringMid;
 
+        // Sites with intermediate waypoints show which one
+        const DatabaseWaypoint_t *waypoint = database_getWaypoint(database_findWaypoint(snapshot.position));
+        if (waypoint)
+        {
+            positionString = (uint8_t *)waypoint->name;
+        }
+
         break;
     case HOOK_STATE_PARTIALLY_OPEN:
         if (hookStatePrevious == HOOK_STATE_MID)
@@ -215,9 +239,9 @@ void remote_updateUi(void)
     }
 
     lcd_set_cursor(3, 1);
-    if (database_getError())
+    if (snapshot.error)
     {
-        lcd_print(">Error Number:%.0f", database_getError());
+        lcd_print(">Error Number:%.0f", snapshot.error);
     }
     else if (database_isReadyForLifting())
     {
@@ -296,6 +320,21 @@ static void stateMachine(void)
     switch (hookState)
     {
     case HOOK_STATE_UNINITIALIZED:
+        // Once per connection, a hook still at the stored homed position does not need homing again.
+        // Only with a position reported on this connection, not one left over from the last.
+        if (!warmStartChecked && !command_isInExecution() && database_hasTelemetry())
+        {
+            warmStartChecked = true;
+            if (storage_isWarmStartValid(database_getPosition()))
+            {
+                hookState = database_getState();
+                buttonsExecute = 0;
+                LOG_INF("Warm start, homing skipped");
+
+                break;
+            }
+        }
+
         stateMessage = stringHome;
         uint32_t buttons = (buttonsExecute & (BUTTON_CLOSE_MASK | BUTTON_MID_MASK | BUTTON_OPEN_MASK));
 
@@ -331,6 +370,10 @@ static void stateMachine(void)
         else if (command_isInExecution())
         {
         }
+        if (hookStatePrevious != HOOK_STATE_CLOSED)
+        {
+            storage_savePosition(database_getPosition());
+        }
         buttonsExecute = 0;
         hookStatePrevious = HOOK_STATE_CLOSED;
 
@@ -352,9 +395,24 @@ static void stateMachine(void)
             command_addToBuffer(&cmd);
             LOG_INF("Executing going to open...");
         }
+        else if ((buttonsExecute & BUTTON_MID_MASK) && !command_isInExecution())
+        {
+            // Sites with several intermediate waypoints step through them with the mid button
+            int32_t next = nextIntermediateWaypoint();
+            if (next > 0)
+            {
+                CommandInput_t cmd = {.operation = COMMAND_HOOK_WAYPOINT, .parameter1 = next};
+                command_addToBuffer(&cmd);
+                LOG_INF("Executing going to waypoint %d...", next);
+            }
+        }
         else if (command_isInExecution())
         {
         }
+        if (hookStatePrevious != HOOK_STATE_MID)
+        {
+            storage_savePosition(database_getPosition());
+        }
         buttonsExecute = 0;
         hookStatePrevious = HOOK_STATE_MID;
 
@@ -379,6 +437,10 @@ static void stateMachine(void)
         else if (command_isInExecution())
         {
         }
+        if (hookStatePrevious != HOOK_STATE_OPEN)
+        {
+            storage_savePosition(database_getPosition());
+        }
         buttonsExecute = 0;
         hookStatePrevious = HOOK_STATE_OPEN;
 
@@ -411,4 +473,16 @@ static void stateMachine(void)
 
         break;
     }
-}
\ No newline at end of file
+}
+
+// Next waypoint between closed and open, wrapping back to the first, or -1 if there is no other
+static int32_t nextIntermediateWaypoint(void)
+{
+    int32_t last = database_getWaypointCount() - 1;
+    int32_t at = database_findWaypoint(database_getPosition());
+
+    if (last < 3 || at <= 0 || at >= last)
+        return -1;
+
+    return (at + 1 < last) ? (at + 1) : 1;
+}
@@ -1,35 +1,20 @@
 #include "spin3204_control.h"
+#include "spin3204_frames.h"
+#include "encoding_checksum.h"
 #include <zephyr/kernel.h>
 
-extern void sendBLE(uint8_t *data, uint8_t len);
+extern void sendBLE(const uint8_t *data, uint8_t len);
+extern void sendBLENoWait(const uint8_t *data, uint8_t len);
+extern void flushBLE(void);
 
 #define TX_BUFFER_LENGTH 64
 
-typedef enum Command_e_
-{
-    SPIN_COMMAND_NONE,
-    SPIN_COMMAND_MOVE,
-    // Reserved from 1 to 9
-    SPIN_COMMAND_STOP = 10,
-    SPIN_COMMAND_EACK,
-    SPIN_COMMAND_REBOOT,
-    SPIN_COMMAND_SET_POSITION,
-    SPIN_COMMAND_SET_PARAMETER,
-    SPIN_COMMAND_READ_PARAMETER,
-    SPIN_COMMAND_READY_FOR_LOADING,
-} Command_e;
-
-#pragma pack(1)
-typedef struct RemoteCommand_t_
-{
-    uint8_t operation;
-    int16_t Parameter1;
-    int16_t Parameter2;
-    int16_t Parameter3;
-
-} RemoteCommand_t;
+// Last value read back from the motor controller, only valid with its bit in parameterKnown
+static int32_t parameterValues[PARAMETER_COUNT];
+static uint32_t parameterKnown = 0;
 
 static bool sendRemoteRequest(uint8_t *data, uint8_t length);
+static bool writeParameter(Parameters_e number, int16_t value);
 
 void mc_moveTo(int16_t target, int16_t speed, uint8_t seqNo)
 {
@@ -43,67 +28,34 @@ void mc_moveTo(int16_t target, int16_t speed, uint8_t seqNo)
 
 void mc_eack(void)
 {
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_EACK,
-                           .Parameter1 = 0,
-                           .Parameter2 = 0,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    sendBLE(spin_frameEack.bytes, sizeof(spin_frameEack.bytes));
 }
 
 void mc_stop(void)
 {
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_STOP,
-                           .Parameter1 = 0,
-                           .Parameter2 = 0,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    sendBLENoWait(spin_frameStop.bytes, sizeof(spin_frameStop.bytes));
+    flushBLE(); // Never held back for coalescing
 }
 
 void mc_reboot(void)
 {
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_REBOOT,
-                           .Parameter1 = 0,
-                           .Parameter2 = 0,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    sendBLE(spin_frameReboot.bytes, sizeof(spin_frameReboot.bytes));
+    mc_invalidateParameters(); // Back to its stored defaults after the restart
 }
 
 void mc_setPositionHome(void)
 {
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_SET_POSITION,
-                           .Parameter1 = 0,
-                           .Parameter2 = 0,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    sendBLE(spin_frameSetPositionHome.bytes, sizeof(spin_frameSetPositionHome.bytes));
 }
 
 void mc_setPositionUninitialized(void)
 {
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_SET_POSITION,
-                           .Parameter1 = INT16_MAX,
-                           .Parameter2 = 0,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    sendBLE(spin_frameSetPositionUninitialized.bytes, sizeof(spin_frameSetPositionUninitialized.bytes));
 }
 
-void mc_setIgnoreSensorParameter(uint8_t ignore)
+bool mc_setIgnoreSensorParameter(uint8_t ignore)
 {
-    if (ignore)
-    {
-        ignore = 1;
-    }
-
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_SET_PARAMETER,
-                           .Parameter1 = PARAMETER_IGNORE_SENSOR,
-                           .Parameter2 = ignore,
-                           .Parameter3 = 0};
-
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    return writeParameter(PARAMETER_IGNORE_SENSOR, ignore ? 1 : 0);
 }
 
 void mc_readParameter(Parameters_e number)
@@ -116,35 +68,80 @@ void mc_readParameter(Parameters_e number)
     sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
 }
 
-void mc_setCurrentLimitParameter(uint16_t value)
+bool mc_setCurrentLimitParameter(uint16_t value)
 {
+    return writeParameter(PARAMETER_CURRENT_LIMIT_VALUE, value);
+}
 
-    RemoteCommand_t cmd = {.operation = SPIN_COMMAND_SET_PARAMETER,
-                           .Parameter1 = PARAMETER_CURRENT_LIMIT_VALUE,
-                           .Parameter2 = value,
-                           .Parameter3 = 0};
+bool mc_setHardwareCurrentLimiter(bool enable)
+{
+    return writeParameter(PARAMETER_CURRENT_LIMIT_TYPE, enable);
+}
 
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+void mc_readParameters(void)
+{
+    // The replies come back through database_run() and land in mc_updateParameter(...)
+    for (Parameters_e number = PARAMETER_KP; number < PARAMETER_COUNT; ++number)
+    {
+        mc_readParameter(number);
+    }
 }
 
-void mc_setHardwareCurrentLimiter(bool enable)
+void mc_updateParameter(Parameters_e number, int32_t value)
 {
+    if (number <= PARAMETER_NONE || number >= PARAMETER_COUNT)
+        return;
+
+    parameterValues[number] = value;
+    parameterKnown |= (1U << number);
+}
+
+bool mc_getParameter(Parameters_e number, int32_t *value)
+{
+    if (number <= PARAMETER_NONE || number >= PARAMETER_COUNT || !(parameterKnown & (1U << number)))
+        return false;
+
+    *value = parameterValues[number];
+    return true;
+}
+
+void mc_invalidateParameters(void)
+{
+    parameterKnown = 0;
+}
+
+static bool writeParameter(Parameters_e number, int16_t value)
+{
+    int32_t cached;
+    if (mc_getParameter(number, &cached) && cached == value)
+        return false;
+
     RemoteCommand_t cmd = {.operation = SPIN_COMMAND_SET_PARAMETER,
-                           .Parameter1 = PARAMETER_CURRENT_LIMIT_TYPE,
-                           .Parameter2 = enable,
+                           .Parameter1 = number,
+                           .Parameter2 = value,
                            .Parameter3 = 0};
 
-    sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t));
+    if (sendRemoteRequest((uint8_t *)&cmd, sizeof(RemoteCommand_t)))
+        return false;
+
+    // Only known again once the read back reply confirms the controller took the value
+    parameterKnown &= ~(1U << number);
+    mc_readParameter(number);
+    return true;
 }
 
 static bool sendRemoteRequest(uint8_t *data, uint8_t length)
 {
-    if (length > TX_BUFFER_LENGTH)
+    if (length + 1 + sizeof(Encoding_LinkChecksum_t) > TX_BUFFER_LENGTH)
         return true;
     uint8_t txBuffer[TX_BUFFER_LENGTH];
-    txBuffer[0] = 0xFE;
+    txBuffer[0] = SPIN_FRAME_HEADER;
     memcpy(&txBuffer[1], data, length);
-    sendBLE(txBuffer, length + 1);
+
+    // Same checksum trailer as the replies, little endian
+    Encoding_LinkChecksum_t fcs = encoding_calculateLinkChecksum(txBuffer, length + 1);
+    memcpy(&txBuffer[length + 1], &fcs, sizeof(fcs));
+    sendBLE(txBuffer, length + 1 + sizeof(fcs));
 
     return false;
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "spin3204_frames.h"
+#include "encoding_checksum.h"
+
+static constexpr SpinFrame_t makeFrame(uint8_t operation, int16_t parameter1, int16_t parameter2, int16_t parameter3)
+{
+    SpinFrame_t frame{};
+    uint8_t *bytes = frame.bytes;
+
+    // Same layout as the packed RemoteCommand_t on the (little endian) target
+    bytes[0] = SPIN_FRAME_HEADER;
+    bytes[1] = operation;
+    bytes[2] = static_cast<uint16_t>(parameter1) & 0xFF;
+    bytes[3] = static_cast<uint16_t>(parameter1) >> 8;
+    bytes[4] = static_cast<uint16_t>(parameter2) & 0xFF;
+    bytes[5] = static_cast<uint16_t>(parameter2) >> 8;
+    bytes[6] = static_cast<uint16_t>(parameter3) & 0xFF;
+    bytes[7] = static_cast<uint16_t>(parameter3) >> 8;
+
+    Encoding_LinkChecksum_t fcs = encoding::linkChecksum(bytes, SPIN_FRAME_SIZE - sizeof(Encoding_LinkChecksum_t));
+    for (uint32_t i = 0; i < sizeof(Encoding_LinkChecksum_t); ++i)
+    {
+        bytes[SPIN_FRAME_SIZE - sizeof(Encoding_LinkChecksum_t) + i] = (fcs >> (8 * i)) & 0xFF;
+    }
+
+    return frame;
+}
+
+static_assert(sizeof(RemoteCommand_t) == 7, "Frame builder assumes a 7 byte RemoteCommand_t");
+
+constexpr SpinFrame_t spin_frameStop = makeFrame(SPIN_COMMAND_STOP, 0, 0, 0);
+constexpr SpinFrame_t spin_frameEack = makeFrame(SPIN_COMMAND_EACK, 0, 0, 0);
+constexpr SpinFrame_t spin_frameReboot = makeFrame(SPIN_COMMAND_REBOOT, 0, 0, 0);
+constexpr SpinFrame_t spin_frameSetPositionHome = makeFrame(SPIN_COMMAND_SET_POSITION, 0, 0, 0);
+constexpr SpinFrame_t spin_frameSetPositionUninitialized = makeFrame(SPIN_COMMAND_SET_POSITION, INT16_MAX, 0, 0);
@@ -0,0 +1,377 @@
+#include "storage.h"
+#include "database.h"
+#include <memory.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+#define LOG_MODULE_NAME storage
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#define STORAGE_SUBTREE "hook"
+#define STORAGE_KEY "warm"
+#define STORAGE_WAYPOINTS_KEY "waypoints" // DatabaseWaypoint_t array, provisioned per site
+#define STORAGE_GATT_KEY "gatt"
+#define STORAGE_VERSION 2
+#define STORAGE_WRITE_DELAY_MS 10000   // Changes within this window end up in one flash write
+#define STORAGE_POSITION_TOLERANCE 50  // Encoder counts between stored and live position
+#define STORAGE_POSITION_UNINITIALIZED INT16_MAX
+
+// StorageWarmStart_t.overridden, calibrated values that differ from the firmware defaults
+#define STORAGE_OVERRIDE_MID_POSITION (1 << 0)
+#define STORAGE_OVERRIDE_OPEN_POSITION (1 << 1)
+#define STORAGE_OVERRIDE_HOMING_SPEED (1 << 2)
+#define STORAGE_OVERRIDE_CLOSING_SPEED (1 << 3)
+#define STORAGE_OVERRIDE_OPENING_SPEED (1 << 4)
+
+// Stored as is, packed so the flash layout does not depend on padding
+#pragma pack(push, 1)
+typedef struct StorageWarmStart_t_
+{
+    uint8_t version;
+    uint8_t homed;
+    uint16_t position;
+    uint16_t midPosition;
+    uint16_t openPosition;
+    int16_t homingSpeed;
+    int16_t closingSpeed;
+    int16_t openingSpeed;
+    uint8_t peer[STORAGE_PEER_SIZE];
+    uint8_t overridden; // Values without their bit are zero and follow the firmware defaults
+} StorageWarmStart_t;
+#pragma pack(pop)
+
+// Version 1 had no override mask and stored every value, the defaults of the firmware included
+#define STORAGE_VERSION_1_SIZE offsetof(StorageWarmStart_t, overridden)
+
+static StorageWarmStart_t pending = {.version = STORAGE_VERSION};   // What should be in flash
+static StorageWarmStart_t persisted = {.version = STORAGE_VERSION}; // What is in flash
+static StorageGattCache_t gattPending;
+static StorageGattCache_t gattPersisted;
+static bool gattValid = false;
+static bool gattStored = false; // hook/gatt exists in flash
+static uint8_t connectedPeer[STORAGE_PEER_SIZE];
+static bool warmStartLoaded = false;
+static DatabaseWaypoint_t loadedWaypoints[DATABASE_MAX_WAYPOINTS];
+static uint32_t loadedWaypointCount = 0;
+static struct k_spinlock lock;
+
+static uint8_t overrideIf(bool changed, uint8_t bit);
+static int storageSet(const char *name, size_t length, settings_read_cb read, void *argument);
+static int storageCommit(void);
+static void storageWrite(struct k_work *work);
+static void schedule(void);
+
+SETTINGS_STATIC_HANDLER_DEFINE(storage, STORAGE_SUBTREE, NULL, storageSet, storageCommit, NULL);
+static K_WORK_DELAYABLE_DEFINE(storageWork, storageWrite);
+
+void storage_setPeer(const uint8_t *peer, uint32_t length)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(connectedPeer, 0, sizeof(connectedPeer));
+    memcpy(connectedPeer, peer, (length < sizeof(connectedPeer)) ? length : sizeof(connectedPeer));
+    k_spin_unlock(&lock, key);
+}
+
+void storage_saveHomed(void)
+{
+    DatabaseCalibration_t defaults;
+    database_getDefaultCalibration(&defaults);
+
+    // Values still at their defaults are left out, a firmware update can then change them
+    uint16_t midPosition = database_convertTargetToValue(HOOK_TARGET_MID);
+    uint16_t openPosition = database_convertTargetToValue(HOOK_TARGET_OPEN);
+    int16_t homingSpeed = database_getHomingSpeed();
+    int16_t closingSpeed = database_getClosingSpeed();
+    int16_t openingSpeed = database_getOpeningSpeed();
+    uint8_t overridden = overrideIf(midPosition != defaults.midPosition, STORAGE_OVERRIDE_MID_POSITION) |
+                         overrideIf(openPosition != defaults.openPosition, STORAGE_OVERRIDE_OPEN_POSITION) |
+                         overrideIf(homingSpeed != defaults.homingSpeed, STORAGE_OVERRIDE_HOMING_SPEED) |
+                         overrideIf(closingSpeed != defaults.closingSpeed, STORAGE_OVERRIDE_CLOSING_SPEED) |
+                         overrideIf(openingSpeed != defaults.openingSpeed, STORAGE_OVERRIDE_OPENING_SPEED);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    pending.homed = 1;
+    pending.position = 0;
+    pending.overridden = overridden;
+    pending.midPosition = (overridden & STORAGE_OVERRIDE_MID_POSITION) ? midPosition : 0;
+    pending.openPosition = (overridden & STORAGE_OVERRIDE_OPEN_POSITION) ? openPosition : 0;
+    pending.homingSpeed = (overridden & STORAGE_OVERRIDE_HOMING_SPEED) ? homingSpeed : 0;
+    pending.closingSpeed = (overridden & STORAGE_OVERRIDE_CLOSING_SPEED) ? closingSpeed : 0;
+    pending.openingSpeed = (overridden & STORAGE_OVERRIDE_OPENING_SPEED) ? openingSpeed : 0;
+    memcpy(pending.peer, connectedPeer, sizeof(pending.peer));
+    k_spin_unlock(&lock, key);
+
+    schedule();
+}
+
+void storage_clearHomed(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    pending.homed = 0;
+    k_spin_unlock(&lock, key);
+
+    schedule();
+}
+
+void storage_savePosition(uint16_t position)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    bool changed = pending.homed && (abs((int32_t)position - (int32_t)pending.position) > STORAGE_POSITION_TOLERANCE);
+    if (changed)
+    {
+        pending.position = position;
+    }
+    k_spin_unlock(&lock, key);
+
+    if (changed)
+    {
+        schedule();
+    }
+}
+
+bool storage_isWarmStartValid(uint16_t livePosition)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    bool result = pending.homed && !memcmp(pending.peer, connectedPeer, sizeof(pending.peer));
+    uint16_t position = pending.position;
+    k_spin_unlock(&lock, key);
+
+    // A motor controller that rebooted since reports an uninitialized position and has to be homed
+    if (result && livePosition != STORAGE_POSITION_UNINITIALIZED)
+    {
+        int32_t difference = (int32_t)(livePosition & 0x7FFF) - (int32_t)(position & 0x7FFF);
+        result = (abs(difference) <= STORAGE_POSITION_TOLERANCE);
+    }
+    else
+    {
+        result = false;
+    }
+
+    LOG_INF("Warm start %s (stored %d, live %d)", result ? "valid" : "rejected", position, livePosition);
+
+    return result;
+}
+
+void storage_saveGattCache(const StorageGattCache_t *cache)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    gattPending = *cache;
+    gattValid = true;
+    k_spin_unlock(&lock, key);
+
+    schedule();
+}
+
+void storage_clearGattCache(const uint8_t *peer, uint32_t length)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint32_t compared = (length < sizeof(gattPending.peer)) ? length : sizeof(gattPending.peer);
+    bool cleared = gattValid && (!peer || !memcmp(gattPending.peer, peer, compared));
+    if (cleared)
+    {
+        memset(&gattPending, 0, sizeof(gattPending));
+        gattValid = false;
+    }
+    k_spin_unlock(&lock, key);
+
+    if (cleared)
+    {
+        schedule();
+    }
+}
+
+bool storage_getGattCache(StorageGattCache_t *cache)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    bool result = gattValid;
+    *cache = gattPending;
+    k_spin_unlock(&lock, key);
+
+    return result;
+}
+
+static uint8_t overrideIf(bool changed, uint8_t bit)
+{
+    return changed ? bit : 0;
+}
+
+static void schedule(void)
+{
+    // Does not push an already pending write further out, so a steady stream of changes still lands
+    k_work_schedule(&storageWork, K_MSEC(STORAGE_WRITE_DELAY_MS));
+}
+
+static void storageWrite(struct k_work *work)
+{
+    StorageWarmStart_t copy;
+    StorageGattCache_t gattCopy;
+    bool gattCopyValid;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    copy = pending;
+    gattCopy = gattPending;
+    gattCopyValid = gattValid;
+    k_spin_unlock(&lock, key);
+
+    if (!gattCopyValid)
+    {
+        // Bond removed, handles of a peer that is no longer trusted do not stay in flash
+        if (gattStored)
+        {
+            int err = settings_delete(STORAGE_SUBTREE "/" STORAGE_GATT_KEY);
+            if (err)
+            {
+                LOG_WRN("Deleting GATT cache failed (err %d)", err);
+            }
+            else
+            {
+                memset(&gattPersisted, 0, sizeof(gattPersisted));
+                gattStored = false;
+            }
+        }
+    }
+    // Flash pages wear out, never rewrite what is already stored
+    else if (!gattStored || memcmp(&gattCopy, &gattPersisted, sizeof(gattCopy)))
+    {
+        int err = settings_save_one(STORAGE_SUBTREE "/" STORAGE_GATT_KEY, &gattCopy, sizeof(gattCopy));
+        if (err)
+        {
+            LOG_WRN("Saving GATT cache failed (err %d)", err);
+        }
+        else
+        {
+            gattPersisted = gattCopy;
+            gattStored = true;
+        }
+    }
+
+    if (!memcmp(&copy, &persisted, sizeof(copy)))
+        return;
+
+    int err = settings_save_one(STORAGE_SUBTREE "/" STORAGE_KEY, &copy, sizeof(copy));
+    if (err)
+    {
+        LOG_WRN("Saving warm start data failed (err %d)", err);
+        return;
+    }
+
+    persisted = copy;
+}
+
+static int storageSet(const char *name, size_t length, settings_read_cb read, void *argument)
+{
+    const char *next;
+
+    if (settings_name_steq(name, STORAGE_WAYPOINTS_KEY, &next) && !next)
+    {
+        if (length % sizeof(DatabaseWaypoint_t) || length > sizeof(loadedWaypoints) ||
+            read(argument, loadedWaypoints, length) != (ssize_t)length)
+        {
+            LOG_WRN("Ignoring stored waypoints");
+            return 0;
+        }
+        loadedWaypointCount = length / sizeof(DatabaseWaypoint_t);
+
+        return 0;
+    }
+
+    if (settings_name_steq(name, STORAGE_GATT_KEY, &next) && !next)
+    {
+        StorageGattCache_t stored;
+        if (length != sizeof(stored) || read(argument, &stored, sizeof(stored)) != sizeof(stored))
+        {
+            LOG_WRN("Ignoring stored GATT cache");
+            return 0;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        gattPending = stored;
+        gattPersisted = stored;
+        gattValid = true;
+        gattStored = true;
+        k_spin_unlock(&lock, key);
+
+        return 0;
+    }
+
+    if (!settings_name_steq(name, STORAGE_KEY, &next) || next)
+        return -ENOENT;
+
+    StorageWarmStart_t stored = {0};
+    bool version1 = (length == STORAGE_VERSION_1_SIZE);
+    if ((length != sizeof(stored) && !version1) || read(argument, &stored, length) != (ssize_t)length ||
+        stored.version != (version1 ? 1 : STORAGE_VERSION))
+    {
+        LOG_WRN("Ignoring stored warm start data");
+        return 0;
+    }
+
+    if (version1)
+    {
+        // Its calibration is the defaults of the firmware that wrote it, only the warm start is kept
+        StorageWarmStart_t upgraded = {.version = STORAGE_VERSION,
+                                       .homed = stored.homed,
+                                       .position = stored.position};
+        memcpy(upgraded.peer, stored.peer, sizeof(upgraded.peer));
+        stored = upgraded;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    pending = stored;
+    persisted = stored;
+    warmStartLoaded = true;
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+// Keys can come in any order, apply them once everything is loaded
+static int storageCommit(void)
+{
+    bool waypointsApplied = false;
+
+    if (loadedWaypointCount)
+    {
+        waypointsApplied = !database_setWaypoints(loadedWaypoints, loadedWaypointCount);
+        if (!waypointsApplied)
+        {
+            LOG_WRN("Stored waypoint table rejected");
+        }
+    }
+
+    if (warmStartLoaded)
+    {
+        // A site waypoint table takes precedence over the calibration saved with the warm start data
+        if (!waypointsApplied)
+        {
+            if ((persisted.overridden & STORAGE_OVERRIDE_MID_POSITION) &&
+                database_setTargetValue(HOOK_TARGET_MID, persisted.midPosition))
+            {
+                LOG_WRN("Stored mid position %d rejected", persisted.midPosition);
+            }
+            if ((persisted.overridden & STORAGE_OVERRIDE_OPEN_POSITION) &&
+                database_setTargetValue(HOOK_TARGET_OPEN, persisted.openPosition))
+            {
+                LOG_WRN("Stored open position %d rejected", persisted.openPosition);
+            }
+        }
+        if (persisted.overridden & STORAGE_OVERRIDE_HOMING_SPEED)
+        {
+            database_setHomingSpeed(persisted.homingSpeed);
+        }
+        if (persisted.overridden & STORAGE_OVERRIDE_CLOSING_SPEED)
+        {
+            database_setClosingSpeed(persisted.closingSpeed);
+        }
+        if (persisted.overridden & STORAGE_OVERRIDE_OPENING_SPEED)
+        {
+            database_setOpeningSpeed(persisted.openingSpeed);
+        }
+    }
+
+    return 0;
+}
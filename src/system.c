@@ -4,9 +4,36 @@
 #include "communications.h"
 #include "database.h"
 #include "commands.h"
+#include "spin3204_control.h"
+#include "storage.h"
 
+#include <zephyr/kernel.h>
+
+#define SYSTEM_PERIOD_MS 25             // Button debouncing and housekeeping
+#define SYSTEM_EVENT_TELEMETRY BIT(0)   // New bytes from the motor controller
+#define SYSTEM_EVENT_BUTTONS BIT(1)     // Button change, an E-stop has to go out right away
+#define SYSTEM_EVENTS (SYSTEM_EVENT_TELEMETRY | SYSTEM_EVENT_BUTTONS)
+#define SYSTEM_LINK_RELAX_MS 2000       // Idle this long before the connection interval is relaxed
+
+typedef enum SystemLink_e_
+{
+    SYSTEM_LINK_UNKNOWN,
+    SYSTEM_LINK_IDLE,
+    SYSTEM_LINK_ACTIVE,
+} SystemLink_e;
+
+extern void setLinkActive(bool active);
+
+static K_EVENT_DEFINE(systemEvents);
+static int64_t nextPeriod = 0;
 static int32_t connection = 0;
 static int32_t enableTimer = 6; // 6 * 500ms
+static bool parametersRequested = false;
+static SystemLink_e linkState = SYSTEM_LINK_UNKNOWN;
+static int64_t lastActive = 0;
+static atomic_t disconnected; // Set by the UI thread, the main thread resets the state it owns
+
+static void updateLink(int64_t now);
 
 void system_init(const void *lcd_dev, const void *cs_dev)
 {
@@ -17,22 +44,90 @@ void system_init(const void *lcd_dev, const void *cs_dev)
 
 void system_thread(void)
 {
+    // Sleep until the motor controller sends something, a button changes or the next period starts
+    int64_t remaining = nextPeriod - k_uptime_get();
+    if (remaining > 0)
+    {
+        k_event_wait(&systemEvents, SYSTEM_EVENTS, false, K_MSEC(remaining));
+    }
+    // Cleared before processing, anything arriving meanwhile wakes the next call straight away
+    k_event_clear(&systemEvents, SYSTEM_EVENTS);
+
+    int64_t now = k_uptime_get();
+    bool period = (now >= nextPeriod);
+    if (period)
+    {
+        nextPeriod += SYSTEM_PERIOD_MS;
+        if (nextPeriod <= now) // Fell behind, do not run a burst of periods to catch up
+        {
+            nextPeriod = now + SYSTEM_PERIOD_MS;
+        }
+    }
+
+    if (atomic_clear(&disconnected))
+    {
+        database_resetTelemetry();
+        command_flush();
+        remote_disconnected();
+    }
+
     database_run();
     if (connection >= enableTimer) // 3s connected
     {
-        remote_run();
+        if (!parametersRequested)
+        {
+            mc_readParameters();
+            parametersRequested = true;
+        }
+        if (period)
+        {
+            remote_run();
+        }
         command_run();
+        updateLink(now);
+    }
+    else if (parametersRequested)
+    {
+        // The motor controller may have rebooted while the link was down
+        mc_invalidateParameters();
+        parametersRequested = false;
+        linkState = SYSTEM_LINK_UNKNOWN;
+    }
+}
+
+// Short connection interval while a command runs or the hook moves, relaxed once it stays idle
+static void updateLink(int64_t now)
+{
+    SystemLink_e wanted = SYSTEM_LINK_IDLE;
+
+    if (command_isInExecution() || !database_isStopped())
+    {
+        lastActive = now;
+        wanted = SYSTEM_LINK_ACTIVE;
+    }
+    else if (linkState == SYSTEM_LINK_ACTIVE && (now - lastActive) < SYSTEM_LINK_RELAX_MS)
+    {
+        // Back to back commands keep the short interval
+        wanted = SYSTEM_LINK_ACTIVE;
+    }
+
+    if (wanted != linkState)
+    {
+        linkState = wanted;
+        setLinkActive(linkState == SYSTEM_LINK_ACTIVE);
     }
 }
 
 void system_updateButtons(uint32_t button_state, uint32_t has_changed)
 {
     remote_updateButtons(button_state, has_changed);
+    k_event_post(&systemEvents, SYSTEM_EVENT_BUTTONS);
 }
 
 void system_receiveUpdate(const uint8_t *data, uint32_t length)
 {
     comm_addToMotorBuffer(data, length);
+    k_event_post(&systemEvents, SYSTEM_EVENT_TELEMETRY);
 }
 
 void system_updateUi(uint8_t connected)
@@ -46,10 +141,16 @@ void system_updateUi(uint8_t connected)
     else
     {
         connection = 0;
+        atomic_set(&disconnected, 1);
         remote_disconnectedUi();
     }
 }
 
+void system_setPeer(const uint8_t *peer, uint32_t length)
+{
+    storage_setPeer(peer, length);
+}
+
 void system_setRssi(int8_t rssi)
 {
     remote_setRssi(rssi);